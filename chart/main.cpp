@@ -13,6 +13,8 @@ using namespace std;
 using namespace boost;
 
 // g++ -Wall -g -std=c++2a -ognup main.cpp gnuplot.hpp -lsqlite3
+// usage: gnup [days], default 1 day from the raw readings, longer ranges
+// read the 5 minute (up to 14 days) or hourly rollup tables
 // see: https://stackoverflow.com/questions/31146713/sqlite3-exec-callback-function-clarification
 
 string ToStdStr(const unsigned char *in){
@@ -40,6 +42,29 @@ int main(int argc, char* argv[]){
    const float y2ticsCount = 6;
 
  
+   // number of days to chart
+   int days = 1;
+   if(argc > 1) {
+      try {
+         days = lexical_cast<int>(argv[1]);
+      }
+      catch(const bad_lexical_cast &){} 
+      if(days < 1) days = 1;
+   } // end if 
+
+   // pick the smallest table that still covers the range, the rollups
+   // are filled by the door daemon and have the same timestamp column
+   string table = dbSensorDataTable;
+   string columns = "temperature,humidity,light";
+   if(days > 14) {
+      table = dbSensorDataTable + "_hourly";
+      columns = "temperature_avg,humidity_avg,light_avg";
+   }
+   else if(days > 1) {
+      table = dbSensorDataTable + "_5min";
+      columns = "temperature_avg,humidity_avg,light_avg";
+   } // end if 
+
    // open db use full path 
    int rc = sqlite3_open(dbFullPath.c_str(), &db);
    if(rc != SQLITE_OK) {
@@ -48,11 +73,15 @@ int main(int argc, char* argv[]){
       return -1;
    } // end if 
    
-   // query string for last 24 hours 
-   string sql = "select timestamp,temperature,humidity,light "
-                "from " + dbSensorDataTable + " " +
-                "where timestamp >= datetime((select max(timestamp) from readings),'-1 day') " +
-                "order by id;";
+   // query string for the last n days, max(timestamp) and the range both use 
+   // the covering index readings_timestamp_ix (or the rollup primary key) 
+   // so there is no table scan.
+   // timestamp is utc epoch seconds, convert to local time for gnuplot
+   string sql = "select datetime(timestamp,'unixepoch','localtime')," + columns + " "
+                "from " + table + " " +
+                "where timestamp >= (select max(timestamp) from " + table + ") - " + 
+                to_string(days * 86400) + " " +
+                "order by timestamp;";
 
    rc = sqlite3_prepare_v2(db, sql.c_str(), -1, &stmt, NULL);
    if(rc != SQLITE_OK) {
@@ -74,26 +103,15 @@ int main(int argc, char* argv[]){
             // read and output each row 
             while((rc = sqlite3_step(stmt)) == SQLITE_ROW) {
                string timestamp = ToStdStr(sqlite3_column_text(stmt, 0));
-               string temperature = ToStdStr(sqlite3_column_text(stmt, 1));
-               string humidity = ToStdStr(sqlite3_column_text(stmt, 2));
-               string light = ToStdStr(sqlite3_column_text(stmt, 3));
-               out << timestamp << "," << temperature << "," << humidity << "," << light << endl;
-
-               // convert and compare to get the temp max in query
-               // and ignore on error 
-               try {
-                  float tempVal = lexical_cast<float>(temperature);
-                  if(tempVal > maxTemp) maxTemp = tempVal;
-               }
-               catch(const bad_lexical_cast &){} 
-
-               // convert and compare to get the light max in query
-               // and ignore on error 
-               try {
-                  float lightVal = lexical_cast<float>(light);
-                  if(lightVal > maxLight) maxLight = lightVal;
-               }
-               catch(const bad_lexical_cast &){} 
+               float temperature = static_cast<float>(sqlite3_column_double(stmt, 1));
+               float humidity = static_cast<float>(sqlite3_column_double(stmt, 2));
+               float light = static_cast<float>(sqlite3_column_double(stmt, 3));
+               out << timestamp << "," << fixed << setprecision(1) 
+                   << temperature << "," << humidity << "," << light << endl;
+
+               // compare to get the temp and light max in query
+               if(temperature > maxTemp) maxTemp = temperature;
+               if(light > maxLight) maxLight = light;
 
             } // end while 
 
@@ -138,11 +156,21 @@ int main(int argc, char* argv[]){
       gp("set grid");
       gp("set tics font ',10'");
       gp("set tics nomirror");
-      gp("set xlabel 'hour:minute' font ',10'");
+      if(days > 1) {
+         gp("set xlabel 'month/day' font ',10'");
+      }
+      else {
+         gp("set xlabel 'hour:minute' font ',10'");
+      } // end if 
       gp("set xlabel offset -1");
       gp("set xdata time");
       gp("set xtics rotate by 45 offset -2.3,-1.2");
-      gp("set format x '%H:%M'");
+      if(days > 1) {
+         gp("set format x '%m/%d'");
+      }
+      else {
+         gp("set format x '%H:%M'");
+      } // end if 
       gp("set ylabel 'degF and %' font ',10'");
       gp("set ytics 0,10");
       gp("set ytics nomirror");
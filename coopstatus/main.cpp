@@ -0,0 +1,83 @@
+#include "../door/CoopStatus.h"
+#include "../door/CommonDef.h"
+#include <iostream>
+#include <iomanip>
+#include <string>
+#include <cstring>
+#include <ctime>
+
+
+using namespace std;
+
+// g++ -Wall -g -std=c++2a -ocoopstatus main.cpp ../door/CoopStatus.cpp -lrt
+// usage: coopstatus [-j]
+// prints the live status the door program publishes in shared memory
+// (door/CoopStatus.h), -j prints it as json for the web page.
+// exits 1 when the door program has not published a status
+
+
+// local time "YYYY-MM-DD HH:MM:SS", "None" for 0
+string TimeToString(int64_t epoch) {
+   if(epoch == 0) return "None";
+
+   time_t sec = static_cast<time_t>(epoch);
+   tm local;
+   localtime_r(&sec, &local);
+
+   char buf[32];
+   strftime(buf, sizeof(buf), "%Y-%m-%d %H:%M:%S", &local);
+   return buf;
+} // end TimeToString
+
+
+void PrintText(const CoopStatusData &sd) {
+
+   cout << fixed << setprecision(1);
+   cout << "updated: " << TimeToString(sd.updated) << " pid " << sd.pid << endl;
+   cout << "door: " << DoorStateToString(static_cast<DoorState>(sd.doorState)) << ", decision: "
+        << DecisionToString(static_cast<Decision>(sd.decision)) << ", mode: "
+        << UserInputToString(static_cast<UserInput>(sd.mode))
+        << (sd.doorHomed != 0 ? "" : ", not homed") << endl;
+   cout << "light: " << sd.light << "lx" << (sd.lightAvailable != 0 ? "" : " (filling)")
+        << ", pi temperature: " << sd.piTemperature << "C" << endl;
+   cout << "temperature: " << sd.temperature << ", humidity: " << sd.humidity << "%, read "
+        << TimeToString(sd.readingTime) << endl;
+   cout << "sunrise: " << TimeToString(sd.sunrise) << ", sunset: " << TimeToString(sd.sunset) << endl;
+   cout << "loop: " << sd.loopPasses << " passes, last " << sd.loopLastUs << "us, max "
+        << sd.loopMaxUs << "us, tick " << sd.loopTickMs << "ms" << endl;
+   cout << "database: " << sd.dbQueueDepth << " queued, " << sd.dbDropped << " dropped" << endl;
+
+   // newest first
+   for(uint32_t i = 0; i < sd.historyCount; ++i) {
+      const DoorStateEntry &entry = sd.history[(sd.historyNext + COOP_STATUS_HISTORY - 1 - i) % COOP_STATUS_HISTORY];
+      cout << "   " << TimeToString(entry.time) << ' ' << setw(14) << left 
+           << DoorStateToString(static_cast<DoorState>(entry.state)) << right << " light " << entry.light << " decision "
+           << DecisionToString(static_cast<Decision>(entry.decision))
+           << " pi " << entry.piTemperature << "C" << endl;
+   } // end for
+
+} // end PrintText
+
+
+int main(int argc, char* argv[]){
+
+   bool json = (argc > 1 && strcmp(argv[1], "-j") == 0);
+
+   CoopStatus status;
+   CoopStatusData sd;
+
+   if(status.OpenReader() != 0 || status.Read(sd) != 0) {
+      if(json == true)
+         cout << "{\"error\":\"" << status.GetErrorStr() << "\"}" << endl;
+      else
+         cout << status.GetErrorStr() << endl;
+      return 1;
+   } // end if
+
+   if(json == true)
+      cout << CoopStatusToJson(sd) << endl;
+   else
+      PrintText(sd);
+
+   return 0;
+} // end main
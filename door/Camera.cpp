@@ -28,17 +28,17 @@ bool Camera::IsDone(){
 
    if(_fut.wait_for(0ms) == future_status::timeout) {
       ret = false;
-      PrintLn((boost::format{ "camera, future timeout: %1%" } % _status).str());
+      PrintLn("camera, future timeout: %1%", _status);
    }
    else if (_fut.wait_for(0ms) == future_status::ready) {
       _status = _fut.get();
       ret = true;
-      PrintLn((boost::format{ "camera, future ready: %1%" } % _status).str());
+      PrintLn("camera, future ready: %1%", _status);
    }
    else {
       _status = _fut.get();
       ret = true;
-      PrintLn((boost::format{ "camera, future differed: %1%" } % _status).str());
+      PrintLn("camera, future differed: %1%", _status);
    } // end if 
 
    return ret;
@@ -0,0 +1,106 @@
+#include "ClockService.h"
+#include <cstring>
+
+
+namespace {
+
+// two digits of v at p, v is 0 to 99
+inline char *Put2(char *p, int v) {
+   p[0] = static_cast<char>('0' + v / 10);
+   p[1] = static_cast<char>('0' + v % 10);
+   return p + 2;
+}
+
+// four digits of v at p, v is 0 to 9999
+inline char *Put4(char *p, int v) {
+   p = Put2(p, v / 100);
+   return Put2(p, v % 100);
+}
+
+// "YYYY-MM-DD" at p
+inline char *PutDate(char *p, const tm &t) {
+   p = Put4(p, t.tm_year + 1900);
+   *p++ = '-';
+   p = Put2(p, t.tm_mon + 1);
+   *p++ = '-';
+   return Put2(p, t.tm_mday);
+}
+
+} // end namespace
+
+
+ClockService::ClockService() {
+   _now = 0;
+   _minuteStart = 0;
+   _monotonicUs = 0;
+   memset(&_local, 0, sizeof(_local));
+   Tick();
+} // end ctor
+
+
+void ClockService::Tick() {
+   timespec ts;
+
+   clock_gettime(CLOCK_MONOTONIC, &ts);
+   _monotonicUs = static_cast<int64_t>(ts.tv_sec) * 1000000 + ts.tv_nsec / 1000;
+
+   clock_gettime(CLOCK_REALTIME, &ts);
+   if(ts.tv_sec == _now) return;
+
+   _now = ts.tv_sec;
+
+   // same minute, the utc offset can't change inside it
+   time_t second = _now - _minuteStart;
+   if(second > 0 && second < 60) {
+      _local.tm_sec = static_cast<int>(second);
+      Put2(_timestamp + 17, _local.tm_sec);
+      return;
+   } // end if
+
+   Refresh();
+
+} // end Tick
+
+
+int64_t ClockService::SinceTickUs() {
+   timespec ts;
+
+   clock_gettime(CLOCK_MONOTONIC, &ts);
+   return static_cast<int64_t>(ts.tv_sec) * 1000000 + ts.tv_nsec / 1000 - _monotonicUs;
+} // end SinceTickUs
+
+
+// a new minute or the clock stepped, convert again
+void ClockService::Refresh() {
+
+   localtime_r(&_now, &_local);
+   _minuteStart = _now - _local.tm_sec;
+
+   // a leap second reads 60, keep the same minute math
+   if(_local.tm_sec > 59) _minuteStart = _now - 59;
+
+   FormatSqlite3(_local, _timestamp);
+
+} // end Refresh
+
+
+void ClockService::FormatSqlite3(const tm &t, char (&out)[CLOCK_TIMESTAMP_SIZE]) {
+   char *p = PutDate(out, t);
+   *p++ = ' ';
+   p = Put2(p, t.tm_hour);
+   *p++ = ':';
+   p = Put2(p, t.tm_min);
+   *p++ = ':';
+   p = Put2(p, t.tm_sec);
+   *p = '\0';
+} // end FormatSqlite3
+
+
+void ClockService::FormatFilename(const tm &t, char (&out)[CLOCK_FILENAME_SIZE]) {
+   char *p = PutDate(out, t);
+   *p++ = '_';
+   p = Put2(p, t.tm_hour);
+   p = Put2(p, t.tm_min);
+   p = Put2(p, t.tm_sec);
+   *p = '\0';
+} // end FormatFilename
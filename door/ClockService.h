@@ -0,0 +1,72 @@
+/// file: ClockService.h header for ClockService class
+/// author: Bennett Cook
+/// date: 10-17-2026
+/// description: the wall and monotonic clocks sampled once per loop pass.
+/// Tick() reads CLOCK_REALTIME and CLOCK_MONOTONIC, the local broken down
+/// time, its utc offset (dst included) and the sqlite3 timestamp text are
+/// cached. A new second only bumps tm_sec and two characters of the text,
+/// localtime_r() runs again on a new minute or a clock step. IsAM(), the
+/// daytime decision and the database timestamps then read the cache
+/// instead of calling time()/localtime() and formatting with ostringstream.
+/// usage: ClockService clock; clock.Tick(); if(clock.IsAM()) ...
+
+
+// header guard
+#ifndef CLOCKSERVICE_H
+#define CLOCKSERVICE_H
+
+#include <ctime>
+#include <cstdint>
+#include <cstddef>
+#include <boost/core/noncopyable.hpp>
+
+
+// "YYYY-MM-DD HH:MM:SS" plus the terminator
+const size_t CLOCK_TIMESTAMP_SIZE = 20;
+
+// "YYYY-MM-DD_HHMMSS" plus the terminator
+const size_t CLOCK_FILENAME_SIZE = 18;
+
+
+class ClockService : private boost::noncopyable {
+public:
+
+   ClockService();
+   ~ClockService() {}
+
+   // sample the clocks, once at the top of each loop pass
+   void Tick();
+
+   // the values of the last Tick()
+   time_t Now() { return _now; }
+   int64_t MonotonicMs() { return _monotonicUs / 1000; }
+   int64_t MonotonicUs() { return _monotonicUs; }
+
+   // microseconds of CLOCK_MONOTONIC since the last Tick(), reads the
+   // clock, for the work time of a loop pass that started with Tick()
+   int64_t SinceTickUs();
+   const tm &Local() { return _local; }
+   long UtcOffsetSec() { return _local.tm_gmtoff; }
+   bool IsAM() { return _local.tm_hour < 12; }
+
+   // cached "YYYY-MM-DD HH:MM:SS" local time of the last Tick()
+   const char *Sqlite3DateTime() { return _timestamp; }
+
+   // fixed width formatters, no allocation, out is always terminated
+   static void FormatSqlite3(const tm &t, char (&out)[CLOCK_TIMESTAMP_SIZE]);
+   static void FormatFilename(const tm &t, char (&out)[CLOCK_FILENAME_SIZE]);
+
+private:
+
+   time_t _now;
+   time_t _minuteStart;    // epoch of second 0 of the cached minute
+   int64_t _monotonicUs;
+   tm _local;
+   char _timestamp[CLOCK_TIMESTAMP_SIZE];
+
+   void Refresh();
+
+}; // end class
+
+
+#endif // end header guard
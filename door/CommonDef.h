@@ -12,6 +12,7 @@
 
 #include <string>
 #include <string_view>
+#include <vector>
 #include <map>
 #include <thread>
 #include <chrono>
@@ -19,6 +20,8 @@
 #include <iostream>
 #include <iomanip>
 
+#include "IoValues.h"
+
 using namespace std;
 
 // // outputs 
@@ -55,9 +58,38 @@ enum class DoorState : int {
    NoChange
 }; // end enum 
 
-// alias for setting or reading io values 
-//                  name,    value  
-using IoValues = std::map<std::string, unsigned>;
+// to string utility
+inline string DoorStateToString(DoorState ds){
+   string ret;
+
+   switch (ds) {
+   case DoorState::Startup:
+      ret = "Startup";
+      break;
+   case DoorState::Open:
+      ret = "Open";
+      break;
+   case DoorState::MovingToClose:
+      ret = "MovingToClose";
+      break;
+   case DoorState::Closed:
+      ret = "Closed";
+      break;
+   case DoorState::MovingToOpen:
+      ret = "MovingToOpen";
+      break;
+   case DoorState::Obstructed:
+      ret = "Obstructed";
+      break;
+   case DoorState::NoChange:
+      ret = "NoChange";
+      break;
+   } // end switch
+
+   return ret;
+} // end DoorStateToString
+
+// setting or reading io values, see IoValues.h
 
 // configuration file data names
 const string CONFIG_APP_NAME = "ChickenCoop.name";
@@ -77,13 +109,63 @@ const string CONFIG_HOMING_PWM_HZ = "ChickenCoop.homing_pwm_hz";
 const string CONFIG_NIGHT_LIGHT_LEVEL = "ChickenCoop.night_light_level";
 const string CONFIG_MORNING_LIGHT_LEVEL = "ChickenCoop.morning_light_level";
 const string CONFIG_SENSOR_READ_INTERVAL_SEC = "ChickenCoop.sensor_read_interval_sec";
+const string CONFIG_LIGHT_READ_INTERVAL_SEC = "ChickenCoop.light_read_interval_sec";
+const string CONFIG_SI7021_HOLD_MODE = "ChickenCoop.si7021_hold_mode";
+const string CONFIG_SI7021_CHECK_CRC = "ChickenCoop.si7021_check_crc";
 const string CONFIG_SUNRISE_OFFSET_MINUTES = "ChickenCoop.sunrise_offset_minutes";
 const string CONFIG_SUNSET_OFFSET_MINUTES = "ChickenCoop.sunset_offset_minutes";
-const string CONFIG_ADDRESS_HOUSE_NUMBER = "ChickenCoop.address.house_number";
-const string CONFIG_ADDRESS_STREET = "ChickenCoop.address.street";
-const string CONFIG_ADDRESS_CITY = "ChickenCoop.address.city";
-const string CONFIG_ADDRESS_STATE = "ChickenCoop.address.state";
-const string CONFIG_ADDRESS_ZIP_CODE = "ChickenCoop.address.zip_code";
+const string CONFIG_LATITUDE = "ChickenCoop.latitude";
+const string CONFIG_LONGITUDE = "ChickenCoop.longitude";
+const string CONFIG_DB_QUEUE_SIZE = "ChickenCoop.database_queue_size";
+const string CONFIG_DB_BATCH_ROWS = "ChickenCoop.database_batch_rows";
+const string CONFIG_DB_BATCH_MS = "ChickenCoop.database_batch_ms";
+const string CONFIG_DB_SYNCHRONOUS = "ChickenCoop.database_synchronous";
+const string CONFIG_DB_RAW_RETENTION_DAYS = "ChickenCoop.database_raw_retention_days";
+const string CONFIG_DB_5MIN_RETENTION_DAYS = "ChickenCoop.database_5min_retention_days";
+const string CONFIG_DB_ROLLUP_INTERVAL_SEC = "ChickenCoop.database_rollup_interval_sec";
+const string CONFIG_EVENT_LOOP = "ChickenCoop.event_loop";
+const string CONFIG_IDLE_TICK_MS = "ChickenCoop.idle_tick_ms";
+const string CONFIG_GPIO_EDGE_EVENTS = "ChickenCoop.gpio_edge_events";
+const string CONFIG_GPIO_DEBOUNCE_US = "ChickenCoop.gpio_debounce_us";
+const string CONFIG_LOG_PATH = "ChickenCoop.log_path";
+const string CONFIG_LOG_MAX_BYTES = "ChickenCoop.log_max_bytes";
+const string CONFIG_LOG_FILES = "ChickenCoop.log_files";
+const string CONFIG_LOG_LEVEL = "ChickenCoop.log_level";
+const string CONFIG_HTTP_PORT = "ChickenCoop.http_port";
+const string CONFIG_HTTP_ADDRESS = "ChickenCoop.http_address";
+const string CONFIG_SUN_TABLE_PATH = "ChickenCoop.sun_table_path";
+
+// defaults for the optional configuration file data 
+const int DEFAULT_DB_QUEUE_SIZE = 256;
+const int DEFAULT_DB_BATCH_ROWS = 32;
+const int DEFAULT_DB_BATCH_MS = 2000;
+const string DEFAULT_DB_SYNCHRONOUS = "NORMAL";
+const int DEFAULT_DB_RAW_RETENTION_DAYS = 30;
+const int DEFAULT_DB_5MIN_RETENTION_DAYS = 365;
+const int DEFAULT_DB_ROLLUP_INTERVAL_SEC = 300;
+const bool DEFAULT_EVENT_LOOP = true;
+const int DEFAULT_IDLE_TICK_MS = 1000;
+const bool DEFAULT_GPIO_EDGE_EVENTS = true;
+const int DEFAULT_GPIO_DEBOUNCE_US = 1000;
+const string DEFAULT_LOG_PATH = "coop.log";
+const int DEFAULT_LOG_MAX_BYTES = 1048576;
+const int DEFAULT_LOG_FILES = 4;
+const string DEFAULT_LOG_LEVEL = "info";
+const int DEFAULT_HTTP_PORT = 8081;
+const string DEFAULT_HTTP_ADDRESS = "127.0.0.1";
+const string DEFAULT_SUN_TABLE_PATH = "sun_table.bin";
+
+// the light sensor runs continuously, a read is a few ms of bus time
+const int DEFAULT_LIGHT_READ_INTERVAL_SEC = 5;
+
+// time covered by the light smoothing filter, 7 reads at the old 30 s
+// interval, the filter length is this over light_read_interval_sec so
+// the AM/PM light decision sees the same window at any read interval
+const int LIGHT_FILTER_WINDOW_SEC = 210;
+
+// the pi i2c controller has trouble with clock stretching, poll instead
+const bool DEFAULT_SI7021_HOLD_MODE = false;
+const bool DEFAULT_SI7021_CHECK_CRC = true;
 
 // string values for digital io type 
 const string DIGITAL_INPUT_STR = "input";
@@ -95,30 +177,6 @@ const string INPUT_RESISTOR_PULLDOWN_STR = "pulldown";
 const string INPUT_RESISTOR_PULLUP_STR = "pullup";
 
 
-struct Address {
-   string house_number;
-   string street;
-   string city;
-   string state;
-   string zip_code;
-}; // end struct
-
-
-struct Coordinates {
-   string longitude;
-   string latitude;
-}; // end struct
-
-struct SunriseSunsetStringTimes {
-   string sunrise;
-   string sunset;
-   string upper_transit;
-   void Print() { cout << "sunrise: " << sunrise << ", sunset: " 
-                       << sunset << ", upper_transit: " 
-                       << upper_transit << endl; }
-}; // end struct
-
-
 // each day check for new Sunrise Sunset at this local time.
 // value chosen so Daylight saving time change happens (in US)
 // at 2am, so check just after that  
@@ -207,11 +265,29 @@ struct AppConfig  {
       nightLight = rhs.nightLight;
       sunriseOffsetMin = rhs.sunriseOffsetMin;
       sunsetOffsetMin = rhs.sunsetOffsetMin;
-      houseNumber = rhs.houseNumber;
-      street = rhs.street;
-      city = rhs.city;
-      state = rhs.state;
-      zipCode = rhs.zipCode;
+      latitude = rhs.latitude;
+      longitude = rhs.longitude;
+      dbQueueSize = rhs.dbQueueSize;
+      dbBatchRows = rhs.dbBatchRows;
+      dbBatchMS = rhs.dbBatchMS;
+      dbSynchronous = rhs.dbSynchronous;
+      dbRawRetentionDays = rhs.dbRawRetentionDays;
+      db5MinRetentionDays = rhs.db5MinRetentionDays;
+      dbRollupIntervalSec = rhs.dbRollupIntervalSec;
+      eventLoop = rhs.eventLoop;
+      idleTickMS = rhs.idleTickMS;
+      gpioEdgeEvents = rhs.gpioEdgeEvents;
+      gpioDebounceUs = rhs.gpioDebounceUs;
+      logPath = rhs.logPath;
+      logMaxBytes = rhs.logMaxBytes;
+      logFiles = rhs.logFiles;
+      logLevel = rhs.logLevel;
+      httpPort = rhs.httpPort;
+      httpAddress = rhs.httpAddress;
+      sunTablePath = rhs.sunTablePath;
+      lightReadIntervalSec = rhs.lightReadIntervalSec;
+      si7021HoldMode = rhs.si7021HoldMode;
+      si7021CheckCrc = rhs.si7021CheckCrc;
    } // end ctor
 
    // assignment operator 
@@ -231,11 +307,29 @@ struct AppConfig  {
       nightLight = rhs.nightLight;
       sunriseOffsetMin = rhs.sunriseOffsetMin;
       sunsetOffsetMin = rhs.sunsetOffsetMin;
-      houseNumber = rhs.houseNumber;
-      street = rhs.street;
-      city = rhs.city;
-      state = rhs.state;
-      zipCode = rhs.zipCode;
+      latitude = rhs.latitude;
+      longitude = rhs.longitude;
+      dbQueueSize = rhs.dbQueueSize;
+      dbBatchRows = rhs.dbBatchRows;
+      dbBatchMS = rhs.dbBatchMS;
+      dbSynchronous = rhs.dbSynchronous;
+      dbRawRetentionDays = rhs.dbRawRetentionDays;
+      db5MinRetentionDays = rhs.db5MinRetentionDays;
+      dbRollupIntervalSec = rhs.dbRollupIntervalSec;
+      eventLoop = rhs.eventLoop;
+      idleTickMS = rhs.idleTickMS;
+      gpioEdgeEvents = rhs.gpioEdgeEvents;
+      gpioDebounceUs = rhs.gpioDebounceUs;
+      logPath = rhs.logPath;
+      logMaxBytes = rhs.logMaxBytes;
+      logFiles = rhs.logFiles;
+      logLevel = rhs.logLevel;
+      httpPort = rhs.httpPort;
+      httpAddress = rhs.httpAddress;
+      sunTablePath = rhs.sunTablePath;
+      lightReadIntervalSec = rhs.lightReadIntervalSec;
+      si7021HoldMode = rhs.si7021HoldMode;
+      si7021CheckCrc = rhs.si7021CheckCrc;
       return *this;
    } // assignment operator
 
@@ -256,11 +350,29 @@ struct AppConfig  {
       nightLight = 0.0f;
       sunriseOffsetMin = 0;
       sunsetOffsetMin = 0;
-      houseNumber = "";
-      street = "";
-      city = "";
-      state = "";
-      zipCode = "";
+      latitude = 0.0;
+      longitude = 0.0;
+      dbQueueSize = 0;
+      dbBatchRows = 0;
+      dbBatchMS = 0;
+      dbSynchronous = "NORMAL";
+      dbRawRetentionDays = 0;
+      db5MinRetentionDays = 0;
+      dbRollupIntervalSec = 0;
+      eventLoop = false;
+      idleTickMS = 0;
+      gpioEdgeEvents = false;
+      gpioDebounceUs = 0;
+      logPath = "";
+      logMaxBytes = 0;
+      logFiles = 0;
+      logLevel = "";
+      httpPort = 0;
+      httpAddress = "";
+      sunTablePath = "";
+      lightReadIntervalSec = DEFAULT_LIGHT_READ_INTERVAL_SEC;
+      si7021HoldMode = DEFAULT_SI7021_HOLD_MODE;
+      si7021CheckCrc = DEFAULT_SI7021_CHECK_CRC;
    } // end Initialize
 
    string appName;               /// application name 
@@ -274,22 +386,41 @@ struct AppConfig  {
    int pwmHzSlow;                /// slow door pwm hertz, used for closing 
    int pwmHzHoming;              /// very slow door pwm hertz, homing and jogging 
    int sensorReadIntervalSec;    /// for all sensors, the read interval in seconds 
-   float morningLight;           /// light threshold to open the door in morning  
-   float nightLight;             /// light threshold to close the door at night  
+   float morningLight;           /// light threshold in lux to open the door in morning  
+   float nightLight;             /// light threshold in lux to close the door at night  
    int sunriseOffsetMin;         /// before/after sunrise offset minutes 
    int sunsetOffsetMin;          /// before/after sunset offset minutes 
-   string houseNumber;
-   string street;
-   string city;
-   string state;
-   string zipCode;
+   double latitude;              /// coop location in degrees, north positive, for the sun times 
+   double longitude;             /// coop location in degrees, east positive 
+   int dbQueueSize;              /// rows the database writer queue holds before dropping
+   int dbBatchRows;              /// commit the database writer batch at this many rows
+   int dbBatchMS;                /// or commit the database writer batch after this many ms
+   string dbSynchronous;         /// sqlite synchronous level, OFF, NORMAL, FULL or EXTRA
+   int dbRawRetentionDays;       /// days of raw sensor rows to keep, 0 keeps them all
+   int db5MinRetentionDays;      /// days of 5 minute rollup rows to keep, 0 keeps them all
+   int dbRollupIntervalSec;      /// seconds between sensor rollup passes, 0 disables rollups
+   bool eventLoop;               /// true waits on the epoll event loop, false sleeps loop_time_ms
+   int idleTickMS;               /// event loop tick in ms while the door is at rest
+   bool gpioEdgeEvents;          /// true wakes the loop on input edges from the gpio character device
+   int gpioDebounceUs;           /// kernel debounce for the input edge events in us, 0 is off
+   string logPath;               /// binary log file, see Logger.h
+   int logMaxBytes;              /// the log is rotated at this size
+   int logFiles;                 /// log files kept, the current one and the rotated ones
+   string logLevel;              /// debug, info, warn or error
+   int httpPort;                 /// port of the http status/command server, 0 disables it
+   string httpAddress;           /// address the http server binds, 127.0.0.1 is this host only
+   string sunTablePath;          /// precomputed sun times for the location, see SunTable.h
+   int lightReadIntervalSec;     /// the light sensor read interval in seconds
+   bool si7021HoldMode;          /// si7021 clock stretched reads
+   bool si7021CheckCrc;          /// reject si7021 reads with a bad crc
 }; // end struct 
 
 
 // constant, enum, and string/cout utils for user selected mode 
 
-// this is where the php web page write the mode file 
-const filesystem::path MODE_FILE{ "/home/bjc/coop/exe/user_input.txt" };
+// the php web page sends the commands to this unix datagram socket,
+// see UserInputIPC.h for the message format 
+const filesystem::path COMMAND_SOCKET{ "/home/bjc/coop/exe/coop.sock" };
 
 // user input values plus an undefined used as a default 
 enum class UserInput : unsigned {
@@ -376,6 +507,18 @@ inline string DecisionToString(Decision dec){
    return ret;
 } // end UserInputToString
 
+
+// from the DecisionToString() text, Undefined if it doesn't match
+inline Decision DecisionFromString(const string &str){
+
+   for(Decision dec : {Decision::Manual_Up, Decision::Manual_Down, Decision::Sunrise_W_Offset,
+                       Decision::Sunset_W_Offset, Decision::AM_Light, Decision::PM_Light}) {
+      if(str == DecisionToString(dec)) return dec;
+   } // end for
+
+   return Decision::Undefined;
+} // end DecisionFromString
+
 // util for stream/cout 
 inline ostream &operator<<(ostream &out, Decision dec) {
    out << DecisionToString(dec);
@@ -0,0 +1,225 @@
+#include "CoopStatus.h"
+#include "CommonDef.h"
+#include <unistd.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <cerrno>
+#include <cstring>
+#include <new>
+#include <sstream>
+#include <iomanip>
+
+
+CoopStatus::CoopStatus() {
+   _block = nullptr;
+   _writer = false;
+   memset(&_data, 0, sizeof(_data));
+} // end ctor
+
+
+CoopStatus::~CoopStatus() {
+   Close();
+} // end dtor
+
+
+int CoopStatus::Create() {
+
+   if(_block != nullptr) return 0;
+
+   // 0644 so the web server user can read it
+   int fd = shm_open(COOP_STATUS_SHM_NAME, O_RDWR | O_CREAT, 0644);
+   if(fd < 0) {
+      _errorStr = string("shm_open() failed: ") + strerror(errno);
+      return -1;
+   } // end if
+
+   // the umask may have taken the read bits
+   fchmod(fd, 0644);
+
+   if(ftruncate(fd, sizeof(CoopStatusBlock)) < 0) {
+      _errorStr = string("ftruncate() failed: ") + strerror(errno);
+      close(fd);
+      return -1;
+   } // end if
+
+   void *mem = mmap(nullptr, sizeof(CoopStatusBlock), PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+   close(fd);
+   if(mem == MAP_FAILED) {
+      _errorStr = string("mmap() failed: ") + strerror(errno);
+      return -1;
+   } // end if
+
+   // a new block each run, even seq is a consistent (empty) block
+   _block = new(mem) CoopStatusBlock;
+   _block->seq.store(0, std::memory_order_relaxed);
+   memset(&_block->data, 0, sizeof(_block->data));
+   _block->magic = COOP_STATUS_MAGIC;
+   _block->version = COOP_STATUS_VERSION;
+   _block->size = sizeof(CoopStatusBlock);
+   _writer = true;
+
+   _data.pid = static_cast<int32_t>(getpid());
+
+   return 0;
+} // end Create
+
+
+int CoopStatus::OpenReader() {
+
+   if(_block != nullptr) return 0;
+
+   int fd = shm_open(COOP_STATUS_SHM_NAME, O_RDONLY, 0);
+   if(fd < 0) {
+      _errorStr = string("no status, is the door program running? ") + strerror(errno);
+      return -1;
+   } // end if
+
+   void *mem = mmap(nullptr, sizeof(CoopStatusBlock), PROT_READ, MAP_SHARED, fd, 0);
+   close(fd);
+   if(mem == MAP_FAILED) {
+      _errorStr = string("mmap() failed: ") + strerror(errno);
+      return -1;
+   } // end if
+
+   _block = static_cast<CoopStatusBlock *>(mem);
+   if(_block->magic != COOP_STATUS_MAGIC || _block->version != COOP_STATUS_VERSION ||
+      _block->size != sizeof(CoopStatusBlock)) {
+      _errorStr = "status block version does not match this program";
+      Close();
+      return -1;
+   } // end if
+
+   _writer = false;
+   return 0;
+} // end OpenReader
+
+
+// the writer leaves the shared memory so a reader sees the last status
+// with its old updated time, the next run creates it over
+void CoopStatus::Close() {
+
+   if(_block == nullptr) return;
+
+   munmap(_block, sizeof(CoopStatusBlock));
+   _block = nullptr;
+   _writer = false;
+
+} // end Close
+
+
+void CoopStatus::AddDoorState(int64_t time, int32_t state, int32_t decision, float light, float piTemperature) {
+
+   DoorStateEntry &entry = _data.history[_data.historyNext % COOP_STATUS_HISTORY];
+   entry.time = time;
+   entry.state = state;
+   entry.decision = decision;
+   entry.light = light;
+   entry.piTemperature = piTemperature;
+
+   _data.historyNext = (_data.historyNext + 1) % COOP_STATUS_HISTORY;
+   if(_data.historyCount < COOP_STATUS_HISTORY) ++_data.historyCount;
+
+   _data.doorState = state;
+   _data.decision = decision;
+
+} // end AddDoorState
+
+
+void CoopStatus::Publish(int64_t now) {
+
+   if(_block == nullptr || _writer == false) return;
+
+   _data.updated = now;
+
+   // odd while the copy is in progress, the release fence keeps the
+   // data stores after the odd seq store
+   uint32_t seq = _block->seq.load(std::memory_order_relaxed);
+   _block->seq.store(seq + 1, std::memory_order_relaxed);
+   std::atomic_thread_fence(std::memory_order_release);
+
+   memcpy(&_block->data, &_data, sizeof(_data));
+
+   _block->seq.store(seq + 2, std::memory_order_release);
+
+} // end Publish
+
+
+int CoopStatus::Read(CoopStatusData &data) {
+
+   if(_block == nullptr) {
+      _errorStr = "status is not open";
+      return -1;
+   } // end if
+
+   for(unsigned i = 0; i < COOP_STATUS_READ_TRIES; ++i) {
+
+      uint32_t before = _block->seq.load(std::memory_order_acquire);
+      if((before & 1) != 0) continue;
+
+      memcpy(&data, &_block->data, sizeof(data));
+
+      std::atomic_thread_fence(std::memory_order_acquire);
+      uint32_t after = _block->seq.load(std::memory_order_relaxed);
+
+      if(before == after) return 0;
+   } // end for
+
+   _errorStr = "status is changing too fast to read";
+   return -1;
+} // end Read
+
+
+// the strings are all from the to string utils, no escaping needed
+string CoopStatusHistoryToJson(const CoopStatusData &data) {
+   ostringstream out;
+
+   out << fixed << setprecision(1) << '[';
+
+   uint32_t count = data.historyCount < COOP_STATUS_HISTORY ? data.historyCount : COOP_STATUS_HISTORY;
+   for(uint32_t i = 0; i < count; ++i) {
+      const DoorStateEntry &entry = data.history[(data.historyNext + COOP_STATUS_HISTORY - 1 - i) % COOP_STATUS_HISTORY];
+      out << (i == 0 ? "" : ",")
+          << "{\"time\":" << entry.time
+          << ",\"state\":" << entry.state
+          << ",\"state_str\":\"" << DoorStateToString(static_cast<DoorState>(entry.state)) << '"'
+          << ",\"decision\":\"" << DecisionToString(static_cast<Decision>(entry.decision)) << '"'
+          << ",\"light\":" << entry.light
+          << ",\"pi_temp\":" << entry.piTemperature << '}';
+   } // end for
+
+   out << ']';
+   return out.str();
+} // end CoopStatusHistoryToJson
+
+
+string CoopStatusToJson(const CoopStatusData &data) {
+   ostringstream out;
+
+   out << fixed << setprecision(1);
+   out << "{\"updated\":" << data.updated
+       << ",\"age\":" << (time(nullptr) - data.updated)
+       << ",\"pid\":" << data.pid
+       << ",\"state\":" << data.doorState
+       << ",\"state_str\":\"" << DoorStateToString(static_cast<DoorState>(data.doorState)) << '"'
+       << ",\"decision\":\"" << DecisionToString(static_cast<Decision>(data.decision)) << '"'
+       << ",\"mode\":\"" << UserInputToString(static_cast<UserInput>(data.mode)) << '"'
+       << ",\"homed\":" << (data.doorHomed != 0 ? "true" : "false")
+       << ",\"light\":" << data.light
+       << ",\"light_available\":" << (data.lightAvailable != 0 ? "true" : "false")
+       << ",\"pi_temp\":" << data.piTemperature
+       << ",\"temperature\":" << data.temperature
+       << ",\"humidity\":" << data.humidity
+       << ",\"reading_time\":" << data.readingTime
+       << ",\"sunrise\":" << data.sunrise
+       << ",\"sunset\":" << data.sunset
+       << ",\"loop_passes\":" << data.loopPasses
+       << ",\"loop_last_us\":" << data.loopLastUs
+       << ",\"loop_max_us\":" << data.loopMaxUs
+       << ",\"loop_tick_ms\":" << data.loopTickMs
+       << ",\"db_queued\":" << data.dbQueueDepth
+       << ",\"db_dropped\":" << data.dbDropped
+       << ",\"history\":" << CoopStatusHistoryToJson(data) << '}';
+
+   return out.str();
+} // end CoopStatusToJson
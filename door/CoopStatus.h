@@ -0,0 +1,138 @@
+/// file: CoopStatus.h header for CoopStatus class
+/// author: Bennett Cook
+/// date: 10-17-2026
+/// description: live status of the door program in POSIX shared memory
+/// (/dev/shm/coop_status). The main loop publishes a CoopStatusData each
+/// pass under a seqlock, readers copy it and retry if the writer was in
+/// the middle of an update. Nothing blocks the writer. The coopstatus
+/// tool reads it for the web page so a page load doesn't query the
+/// database for the current state.
+
+
+// header guard
+#ifndef COOPSTATUS_H
+#define COOPSTATUS_H
+
+#include <cstdint>
+#include <cstddef>
+#include <ctime>
+#include <string>
+#include <atomic>
+#include <boost/core/noncopyable.hpp>
+
+using namespace std;
+
+
+const char COOP_STATUS_SHM_NAME[] = "/coop_status";
+const uint32_t COOP_STATUS_MAGIC = 0x504f4f43;    // "COOP"
+const uint32_t COOP_STATUS_VERSION = 1;
+
+// door state changes kept in the block, newest last
+const size_t COOP_STATUS_HISTORY = 10;
+
+// a reader gives up after this many torn copies in a row
+const unsigned COOP_STATUS_READ_TRIES = 1000;
+
+
+// one door state change, same data as a door_state table row
+struct DoorStateEntry {
+   int64_t time;              // utc epoch
+   int32_t state;             // DoorState
+   int32_t decision;          // Decision
+   float light;
+   float piTemperature;
+}; // end struct
+
+
+// plain data so a reader can copy it, all times are utc epoch, 0 is unknown
+struct CoopStatusData {
+   int64_t updated;
+   int32_t pid;
+
+   // door
+   int32_t doorState;         // DoorState of the last door_state row
+   int32_t decision;          // Decision
+   int32_t mode;              // UserInput
+   int32_t doorHomed;
+
+   // sensors
+   float light;               // filtered lux
+   int32_t lightAvailable;
+   float piTemperature;       // deg C
+   float temperature;         // ambient
+   float humidity;
+   int64_t readingTime;
+
+   // sun
+   int64_t sunrise;
+   int64_t sunset;
+
+   // loop health
+   uint64_t loopPasses;
+   uint32_t loopLastUs;       // work time of the last pass, not the wait
+   uint32_t loopMaxUs;
+   uint32_t loopTickMs;
+   uint32_t dbQueueDepth;     // rows waiting for the database writer
+   uint64_t dbDropped;
+
+   // door state history, a ring, historyNext is the next slot to write
+   uint32_t historyCount;
+   uint32_t historyNext;
+   DoorStateEntry history[COOP_STATUS_HISTORY];
+}; // end struct
+
+
+// the shared memory layout
+struct CoopStatusBlock {
+   uint32_t magic;
+   uint32_t version;
+   uint32_t size;             // sizeof(CoopStatusBlock) of the writer
+   std::atomic<uint32_t> seq; // odd while the writer updates data
+   CoopStatusData data;
+}; // end struct
+
+
+class CoopStatus : private boost::noncopyable {
+public:
+
+   CoopStatus();
+   ~CoopStatus();
+
+   // create (writer) or open read only (reader) the shared memory
+   int Create();
+   int OpenReader();
+   void Close();
+
+   // the writer's copy, change it then Publish()
+   CoopStatusData &Data() { return _data; }
+
+   // add a door state change at time (utc epoch) to the history ring of Data()
+   void AddDoorState(int64_t time, int32_t state, int32_t decision, float light, float piTemperature);
+
+   // copy Data() to the shared memory under the seqlock, now (utc epoch)
+   // is the updated time
+   void Publish(int64_t now);
+
+   // reader, a consistent copy of the published data
+   int Read(CoopStatusData &data);
+
+   string GetErrorStr() { return _errorStr; }
+
+private:
+   CoopStatusBlock *_block;
+   bool _writer;
+   CoopStatusData _data;
+   string _errorStr;
+
+}; // end class
+
+
+// the status as a json object with a "history" array, newest first, for
+// the coopstatus tool and the http server
+string CoopStatusToJson(const CoopStatusData &data);
+
+// only the door state history, a json array, newest first
+string CoopStatusHistoryToJson(const CoopStatusData &data);
+
+
+#endif // end header guard
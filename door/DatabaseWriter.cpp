@@ -0,0 +1,281 @@
+#include "DatabaseWriter.h"
+#include <iostream>
+#include <cstring>
+
+
+// copy a string into a fixed DbRow column, truncate if needed
+template<size_t N>
+static void CopyText(char (&dst)[N], const string &src) {
+   size_t len = min(src.size(), N - 1);
+   memcpy(dst, src.data(), len);
+   dst[len] = '\0';
+} // end CopyText
+
+
+DatabaseWriter::DatabaseWriter(UpdateDatabase &udb, unsigned queueSize, unsigned batchRows, unsigned batchMS) :
+   _udb(udb), _queue(queueSize) {
+
+   _batchRows = (batchRows > 0 ? batchRows : 1);
+   _batchMS = chrono::milliseconds{batchMS > 0 ? batchMS : 1};
+   _rollupInterval = chrono::seconds{0};
+   _stop = false;
+
+   _pushed = 0;
+   _popped = 0;
+   _dropped = 0;
+   _written = 0;
+   _failed = 0;
+   _commits = 0;
+   _lastCommitUs = 0;
+   _maxCommitUs = 0;
+} // end ctor
+
+
+DatabaseWriter::~DatabaseWriter() {
+   Stop();
+} // end dtor
+
+
+int DatabaseWriter::Start() {
+
+   if(_thread.joinable() == true) {
+      SetError("writer thread is already running");
+      return -1;
+   } // end if
+
+   _stop = false;
+   _thread = thread([this]() { this->WriterTask(); });
+
+   return 0;
+} // end Start
+
+
+void DatabaseWriter::Stop() {
+
+   if(_thread.joinable() == false) return;
+
+   _stop = true;
+   _wakeCv.notify_one();
+   _thread.join();
+
+} // end Stop
+
+
+int DatabaseWriter::PushDoorStateRow(const string &timestamp,
+                                     int state,
+                                     const string &light,
+                                     const string &temperature,
+                                     const string &decision) {
+   DbRow row{};
+   row.type = DbRowType::DoorState;
+   row.state = state;
+   CopyText(row.timestamp, timestamp);
+   CopyText(row.text[0], light);
+   CopyText(row.text[1], temperature);
+   CopyText(row.text[2], decision);
+
+   return Push(row);
+} // end PushDoorStateRow
+
+
+int DatabaseWriter::PushSensorDataRow(time_t timestamp,
+                                      float temperature,
+                                      float humidity,
+                                      float light) {
+   DbRow row{};
+   row.type = DbRowType::SensorData;
+   row.time = timestamp;
+   row.values[0] = temperature;
+   row.values[1] = humidity;
+   row.values[2] = light;
+
+   return Push(row);
+} // end PushSensorDataRow
+
+
+int DatabaseWriter::PushSunDataRow(const string &timestamp,
+                                   const string &sunrise,
+                                   const string &sunset) {
+   DbRow row{};
+   row.type = DbRowType::SunData;
+   CopyText(row.timestamp, timestamp);
+   CopyText(row.text[0], sunrise);
+   CopyText(row.text[1], sunset);
+
+   return Push(row);
+} // end PushSunDataRow
+
+
+DatabaseWriterStats DatabaseWriter::GetStats() {
+   DatabaseWriterStats ret;
+
+   ret.pushed = _pushed;
+   ret.dropped = _dropped;
+   ret.written = _written;
+   ret.failed = _failed;
+   ret.commits = _commits;
+   ret.lastCommitUs = _lastCommitUs;
+   ret.maxCommitUs = _maxCommitUs;
+
+   // read popped first so depth never goes negative
+   uint64_t popped = _popped;
+   uint64_t pushed = _pushed;
+   ret.queueDepth = (pushed > popped ? pushed - popped : 0);
+
+   return ret;
+} // end GetStats
+
+
+string DatabaseWriter::GetErrorStr() {
+   lock_guard<mutex> lock(_errorMtx);
+   return _errorStr;
+} // end GetErrorStr
+
+
+// the producer side, bounded_push() never allocates and never blocks
+int DatabaseWriter::Push(const DbRow &row) {
+
+   if(_queue.bounded_push(row) == false) {
+      ++_dropped;
+      return -1;
+   } // end if
+
+   uint64_t depth = ++_pushed - _popped;
+
+   // wake the writer early for a full batch, a missed wakeup
+   // only delays the commit to the next batchMS timeout
+   if(depth >= _batchRows) {
+      _wakeCv.notify_one();
+   } // end if
+
+   return 0;
+} // end Push
+
+
+void DatabaseWriter::WriterTask() {
+
+   // first rollup one interval after start, not during the startup burst
+   auto nextRollup = chrono::steady_clock::now() + _rollupInterval;
+
+   while(_stop == false) {
+
+      {
+         unique_lock<mutex> lock(_wakeMtx);
+         _wakeCv.wait_for(lock, _batchMS, [this]() {
+            return _stop == true || (_pushed - _popped) >= _batchRows;
+         });
+      }
+
+      DrainAndCommit();
+
+      // rollups share the connection, so they run here between batches,
+      // rows pushed meanwhile wait in the queue
+      if(_rollupInterval.count() > 0 && chrono::steady_clock::now() >= nextRollup) {
+         Rollup();
+         nextRollup = chrono::steady_clock::now() + _rollupInterval;
+      } // end if
+
+   } // end while
+
+   // commit anything pushed before Stop()
+   DrainAndCommit();
+
+} // end WriterTask
+
+
+// pop the queued rows and commit them, at most _batchRows per transaction
+void DatabaseWriter::DrainAndCommit() {
+
+   DbRow row;
+   bool more = _queue.pop(row);
+
+   while(more == true) {
+
+      auto start = chrono::steady_clock::now();
+
+      if(_udb.BeginTransaction() != 0) {
+         SetError(_udb.GetErrorStr());
+
+         // count the row already popped plus the rest of the queue as lost,
+         // better to drop than to let the control loop see a full queue forever
+         uint64_t lost = 1;
+         ++_popped;
+         while(_queue.pop(row) == true) { ++_popped; ++lost; }
+         _failed += lost;
+         return;
+      } // end if
+
+      unsigned count = 0;
+      unsigned inserted = 0;
+
+      do {
+         ++_popped;
+         ++count;
+         if(InsertRow(row) == 0) {
+            ++inserted;
+         }
+         else {
+            ++_failed;
+            SetError(_udb.GetErrorStr());
+         } // end if
+
+         more = _queue.pop(row);
+      } while(more == true && count < _batchRows);
+
+      if(_udb.CommitTransaction() == 0) {
+         _written += inserted;
+         ++_commits;
+      }
+      else {
+         SetError(_udb.GetErrorStr());
+         _udb.RollbackTransaction();
+         _failed += inserted;
+      } // end if
+
+      uint64_t us = chrono::duration_cast<chrono::microseconds>(chrono::steady_clock::now() - start).count();
+      _lastCommitUs = us;
+      if(us > _maxCommitUs) _maxCommitUs = us;
+
+   } // end while
+
+} // end DrainAndCommit
+
+
+void DatabaseWriter::Rollup() {
+
+   if(_udb.RollupSensorData(time(nullptr)) != 0) {
+      SetError(_udb.GetErrorStr());
+   } // end if
+
+} // end Rollup
+
+
+int DatabaseWriter::InsertRow(const DbRow &row) {
+   int ret = 0;
+
+   switch(row.type) {
+   case DbRowType::DoorState:
+      ret = _udb.AddDoorStateRow(row.timestamp, row.state, row.text[0], row.text[1], row.text[2]);
+      break;
+   case DbRowType::SensorData:
+      ret = _udb.AddSensorDataRow(static_cast<time_t>(row.time), row.values[0],
+                                  row.values[1], row.values[2]);
+      break;
+   case DbRowType::SunData:
+      ret = _udb.AddSunDataRow(row.timestamp, row.text[0], row.text[1]);
+      break;
+   } // end switch
+
+   return ret;
+} // end InsertRow
+
+
+void DatabaseWriter::SetError(const string &errorStr) {
+   {
+      lock_guard<mutex> lock(_errorMtx);
+      _errorStr = errorStr;
+   }
+
+   // the control loop doesn't wait for the result, so report here
+   cout << "database write error: " << errorStr << endl;
+} // end SetError
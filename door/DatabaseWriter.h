@@ -0,0 +1,141 @@
+/// file: DatabaseWriter.h header for DatabaseWriter class
+/// author: Bennett Cook
+/// date: 10-17-2026
+/// description: a background thread that owns the UpdateDatabase
+/// connection. The control loop pushes fixed size row records into a
+/// bounded lock-free queue and never waits on the sd card, the writer
+/// thread drains the queue and commits the rows in grouped transactions,
+/// either every batchRows rows or every batchMS milliseconds. Between
+/// batches it also runs the readings rollup and retention pruning.
+
+
+// header guard
+#ifndef DATABASEWRITER_H
+#define DATABASEWRITER_H
+
+#include <string>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <boost/lockfree/queue.hpp>
+#include <boost/core/noncopyable.hpp>
+
+#include "UpdateDatabase.h"
+
+using namespace std;
+
+
+// which table a DbRow goes to
+enum class DbRowType : int {
+   DoorState = 0,
+   SensorData,
+   SunData
+}; // end enum
+
+// fixed text column size, the longest value is a timestamp or a Decision string
+const size_t DB_ROW_TEXT_SIZE = 24;
+const size_t DB_ROW_TEXT_COLUMNS = 3;
+
+// a fixed size, trivially copyable row record so it can live in the
+// lock-free queue without any allocation on push.
+// column use by type:
+//   DoorState:  timestamp, state, text: light, temperature, decision
+//   SensorData: time, values: temperature, humidity, light
+//   SunData:    timestamp, text: sunrise, sunset
+struct DbRow {
+   DbRowType type;
+   int state;
+   int64_t time;
+   float values[3];
+   char timestamp[DB_ROW_TEXT_SIZE];
+   char text[DB_ROW_TEXT_COLUMNS][DB_ROW_TEXT_SIZE];
+}; // end struct
+
+
+// counters read by the control loop, all values are totals since Start()
+// except queueDepth and the latencies
+struct DatabaseWriterStats {
+   uint64_t pushed;          /// rows accepted by Push...()
+   uint64_t dropped;         /// rows refused because the queue was full
+   uint64_t written;         /// rows committed to the database
+   uint64_t failed;          /// rows lost to an insert or commit error
+   uint64_t commits;         /// transactions committed
+   uint64_t queueDepth;      /// rows waiting in the queue now
+   uint64_t lastCommitUs;    /// latency of the last begin/insert/commit in us
+   uint64_t maxCommitUs;     /// worst commit latency in us
+}; // end struct
+
+
+class DatabaseWriter : private boost::noncopyable {
+public:
+
+   DatabaseWriter(UpdateDatabase &udb, unsigned queueSize, unsigned batchRows, unsigned batchMS);
+   ~DatabaseWriter();
+
+   // seconds between UpdateDatabase::RollupSensorData() calls on the
+   // writer thread, 0 (the default) never runs it. Set before Start()
+   void SetRollupIntervalSec(unsigned sec) { _rollupInterval = chrono::seconds{sec}; }
+
+   // start and stop the writer thread, Stop() commits what is left in the queue
+   int Start();
+   void Stop();
+
+   // return 0 the row is queued
+   // return -1 the queue is full and the row was dropped
+   int PushDoorStateRow(const string &timestamp,
+                        int state,
+                        const string &light,
+                        const string &temperature,
+                        const string &decision);
+
+   int PushSensorDataRow(time_t timestamp,
+                         float temperature,
+                         float humidity,
+                         float light);
+
+   int PushSunDataRow(const string &timestamp,
+                      const string &sunrise,
+                      const string &sunset);
+
+   DatabaseWriterStats GetStats();
+   string GetErrorStr();
+
+private:
+
+   UpdateDatabase &_udb;
+   boost::lockfree::queue<DbRow> _queue;
+   unsigned _batchRows;
+   chrono::milliseconds _batchMS;
+   chrono::seconds _rollupInterval;
+
+   thread _thread;
+   std::atomic<bool> _stop;
+   mutex _wakeMtx;
+   condition_variable _wakeCv;
+
+   std::atomic<uint64_t> _pushed;
+   std::atomic<uint64_t> _popped;
+   std::atomic<uint64_t> _dropped;
+   std::atomic<uint64_t> _written;
+   std::atomic<uint64_t> _failed;
+   std::atomic<uint64_t> _commits;
+   std::atomic<uint64_t> _lastCommitUs;
+   std::atomic<uint64_t> _maxCommitUs;
+
+   mutex _errorMtx;
+   string _errorStr;
+
+   int Push(const DbRow &row);
+   void WriterTask();
+   void DrainAndCommit();
+   void Rollup();
+   int InsertRow(const DbRow &row);
+   void SetError(const string &errorStr);
+
+}; // end class
+
+
+#endif // end header guard
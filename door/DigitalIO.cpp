@@ -1,15 +1,181 @@
 
 #include "DigitalIO.h"
 #include <wiringPi.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <sys/ioctl.h>
+#include <linux/gpio.h>
+#include <cerrno>
+#include <cstring>
 
-DigitalIO::DigitalIO(){
+DigitalIO::DigitalIO() : _edges(IO_EDGE_QUEUE_SIZE) {
    wiringPiSetup();	// Initialize wiringPi
+   _boundSize = 0;
+   _bulkIo = false;
+   _outputsWritten = false;
+   _outputLevels = 0;
+   _edgeFd = -1;
+   _droppedEdges = 0;
 } // end ctor 
   
 DigitalIO::~DigitalIO(){
+   DisableEdgeEvents();
 } // end dtor 
 
 
+// the pins in the configuration are wiringPi numbers, the character
+// device wants the bcm gpio numbers (line offsets on gpiochip0).
+// wiringPi still owns the pull up/down and the reads, the line request
+// only adds the edge detection and uses the same bias.
+// the edges carry IoValues handles, so call BindIoValues() first
+int DigitalIO::EnableEdgeEvents(unsigned debounceUs){
+
+   if(_edgeFd >= 0) return 0;
+
+   if(_inputs.empty() == true) {
+      _errorStr = "no bound digital inputs for edge events";
+      return -1;
+   } // end if 
+
+   gpio_v2_line_request req;
+   memset(&req, 0, sizeof(req));
+
+   uint64_t pullUpMask = 0;
+   uint64_t pullDownMask = 0;
+   uint64_t biasOffMask = 0;
+   unsigned numLines = 0;
+   _edgeHandles.clear();
+
+   for(const IoPin &input : _inputs){
+
+      int gpio = wpiPinToGpio(static_cast<int>(input.pin));
+      if(gpio < 0 || numLines >= GPIO_V2_LINES_MAX) {
+         _errorStr = "no gpio line for input pin: " + to_string(input.pin);
+         return -1;
+      } // end if 
+
+      uint64_t bit = UINT64_C(1) << numLines;
+      if(input.mode == InputResistorMode::PullUp) pullUpMask |= bit;
+      else if(input.mode == InputResistorMode::PullDown) pullDownMask |= bit;
+      else biasOffMask |= bit;
+
+      req.offsets[numLines++] = static_cast<uint32_t>(gpio);
+      _edgeHandles[static_cast<unsigned>(gpio)] = input.handle;
+   } // end for
+
+   const uint64_t flags = GPIO_V2_LINE_FLAG_INPUT | GPIO_V2_LINE_FLAG_EDGE_RISING | GPIO_V2_LINE_FLAG_EDGE_FALLING;
+   req.config.flags = flags;
+
+   // per line bias, then one debounce for every line
+   unsigned attr = 0;
+   auto AddFlags = [&](uint64_t bias, uint64_t mask) {
+      if(mask == 0) return;
+      req.config.attrs[attr].attr.id = GPIO_V2_LINE_ATTR_ID_FLAGS;
+      req.config.attrs[attr].attr.flags = flags | bias;
+      req.config.attrs[attr].mask = mask;
+      ++attr;
+   }; // end lambda
+
+   AddFlags(GPIO_V2_LINE_FLAG_BIAS_PULL_UP, pullUpMask);
+   AddFlags(GPIO_V2_LINE_FLAG_BIAS_PULL_DOWN, pullDownMask);
+   AddFlags(GPIO_V2_LINE_FLAG_BIAS_DISABLED, biasOffMask);
+
+   if(debounceUs > 0) {
+      req.config.attrs[attr].attr.id = GPIO_V2_LINE_ATTR_ID_DEBOUNCE;
+      req.config.attrs[attr].attr.debounce_period_us = debounceUs;
+      req.config.attrs[attr].mask = (numLines == 64 ? ~UINT64_C(0) : (UINT64_C(1) << numLines) - 1);
+      ++attr;
+   } // end if 
+
+   req.config.num_attrs = attr;
+   req.num_lines = numLines;
+   strncpy(req.consumer, "coop", sizeof(req.consumer) - 1);
+
+   int chipFd = open(GPIO_CHIP_PATH.c_str(), O_RDONLY | O_CLOEXEC);
+   if(chipFd < 0) {
+      _errorStr = "open " + GPIO_CHIP_PATH + " failed: " + strerror(errno);
+      return -1;
+   } // end if 
+
+   int result = ioctl(chipFd, GPIO_V2_GET_LINE_IOCTL, &req);
+   int ioctlErrno = errno;
+   close(chipFd);
+
+   if(result < 0) {
+      _errorStr = string("gpio line request failed: ") + strerror(ioctlErrno);
+      return -1;
+   } // end if 
+
+   // the event loop does the waiting, ReadEdges() must not block
+   int fl = fcntl(req.fd, F_GETFL);
+   fcntl(req.fd, F_SETFL, fl | O_NONBLOCK);
+
+   _edgeFd = req.fd;
+   _edges.clear();
+   return 0;
+} // end EnableEdgeEvents
+
+
+void DigitalIO::DisableEdgeEvents(){
+
+   if(_edgeFd < 0) return;
+
+   close(_edgeFd);
+   _edgeFd = -1;
+
+} // end DisableEdgeEvents
+
+
+int DigitalIO::ReadEdges(){
+   gpio_v2_line_event events[16];
+
+   if(_edgeFd < 0) {
+      _errorStr = "edge events not enabled";
+      return -1;
+   } // end if 
+
+   while(true) {
+      ssize_t len = read(_edgeFd, events, sizeof(events));
+      if(len < 0) {
+         if(errno == EAGAIN || errno == EWOULDBLOCK) break;
+         if(errno == EINTR) continue;
+
+         _errorStr = string("gpio edge read failed: ") + strerror(errno);
+         return -1;
+      } // end if 
+
+      size_t count = static_cast<size_t>(len) / sizeof(gpio_v2_line_event);
+      if(count == 0) break;
+
+      for(size_t i = 0; i < count; ++i) {
+         auto handle = _edgeHandles.find(events[i].offset);
+         if(handle == _edgeHandles.end()) continue;
+
+         if(_edges.full() == true) ++_droppedEdges;
+
+         IoEdge edge;
+         edge.handle = handle->second;
+         edge.value = (events[i].id == GPIO_V2_LINE_EVENT_RISING_EDGE ? 1u : 0u);
+         edge.timestampNs = events[i].timestamp_ns;
+         _edges.push_back(edge);
+      } // end for
+
+   } // end while
+
+   return 0;
+} // end ReadEdges
+
+
+bool DigitalIO::PopEdge(IoEdge &edge){
+
+   if(_edges.empty() == true) return false;
+
+   edge = _edges.front();
+   _edges.pop_front();
+   return true;
+} // end PopEdge
+
+
 int DigitalIO::SetIoPoints(const vector<IoConfig> &dioVect){
    int ret = 0;
 
@@ -53,53 +219,120 @@ int DigitalIO::ConfigureHardware(){
 } // end ConfigureHardware
 
 
-int DigitalIO::ReadAll(IoValues &io){
-   int ret = 0;
-  
-   // read the requested inputs and return in value vect
-   for(auto iter = io.begin();  iter != io.end(); ++iter){
+// resolve the io value names to pins once, ReadAll() and SetOutputs()
+// then walk the input and output tables with no name lookups
+int DigitalIO::BindIoValues(const IoValues &io){
+
+   _inputs.clear();
+   _outputs.clear();
+   _boundSize = 0;
+   _outputsWritten = false;
+
+   // the bulk path needs the wiringPi register mapping and every pin in bank 0
+   _bulkIo = (_wiringPiGpio != nullptr);
+
+   for(IoHandle h = 0; h < io.Size(); ++h){
 
       unsigned pin = 0;
-      int result = GetPinForName(iter->first, pin);
+      int result = GetPinForName(io.Name(h), pin);
       if(result != 0){
-         _errorStr = "IO name not found: " + iter->first; 
+         _errorStr = "IO name not found: " + io.Name(h); 
          return -1;
       } // end if 
 
-      _mtx.lock();
-      iter->second = static_cast<unsigned>(digitalRead(pin));
-      _mtx.unlock();
-  
+      int gpio = wpiPinToGpio(static_cast<int>(pin));
+      uint32_t mask = 0;
+      if(gpio >= 0 && gpio < 32) {
+         mask = UINT32_C(1) << gpio;
+      }
+      else {
+         _bulkIo = false;
+      } // end if 
+
+      const IoConfig &config = _dios[io.Name(h)];
+      IoPin ioPin{h, pin, config.resistor_mode, mask};
+      if(config.type == PinType::DOutput){
+         _outputs.push_back(ioPin);
+      }
+      else {
+         _inputs.push_back(ioPin);
+      } // end if 
+
    } // end for 
 
+   _boundSize = io.Size();
+   return 0;
+} // end BindIoValues
+
+
+int DigitalIO::ReadAll(IoValues &io){
+   int ret = 0;
+
+   if(io.Size() != _boundSize){
+      _errorStr = "io values not bound, call BindIoValues()"; 
+      return -1;
+   } // end if 
+  
+   // read the inputs into the snapshot, the outputs are owned by the caller
+   lock_guard<mutex> lock(_mtx);
+
+   if(_bulkIo == true) {
+
+      // one register read, every input from the same instant
+      uint32_t levels = _wiringPiGpio[GPIO_REG_GPLEV0];
+      for(const IoPin &input : _inputs){
+         io.Set(input.handle, (levels & input.mask) != 0 ? 1u : 0u);
+      } // end for 
+   }
+   else {
+      for(const IoPin &input : _inputs){
+         io.Set(input.handle, static_cast<unsigned>(digitalRead(input.pin)));
+      } // end for 
+   } // end if 
+
    return ret;
 } // end ReadInputs
 
 
 int DigitalIO::SetOutputs(const IoValues &io){
-    int ret = 0;
+   int ret = 0;
 
-   // read the requested inputs and return in value vect
-   for(auto iter = io.begin();  iter != io.end(); ++iter){
+   if(io.Size() != _boundSize){
+      _errorStr = "io values not bound, call BindIoValues()"; 
+      return -1;
+   } // end if 
 
-      unsigned pin = 0;
-      int result = GetPinForName(iter->first, pin);
-      if(result != 0){
-         _errorStr = "IO name not found: " + iter->first; 
-         return -1;
-      } // end if 
+   // the new output levels and the ones that differ from the last write,
+   // the first call writes every output
+   uint32_t levels = 0;
+   uint32_t all = 0;
+   for(const IoPin &output : _outputs){
+      all |= output.mask;
+      if(io.Get(output.handle) != 0) levels |= output.mask;
+   } // end for 
 
-      // write the outputs only 
-      if(_dios[iter->first].type == PinType::DOutput){
-         _mtx.lock();
-         digitalWrite(pin, static_cast<int>(iter->second));
-         // cout << iter->first << ":" << static_cast<int>(iter->second) << ","; 
-         _mtx.unlock();
-      } // end if 
+   uint32_t changed = (_outputsWritten == true ? (levels ^ _outputLevels) : all);
 
-   } // end for 
-   
-   // cout << endl;
+   lock_guard<mutex> lock(_mtx);
+
+   if(_bulkIo == true) {
+
+      // GPSET0/GPCLR0 only act on the 1 bits, so the other pins are untouched
+      uint32_t setMask = changed & levels;
+      uint32_t clrMask = changed & ~levels;
+      if(setMask != 0) _wiringPiGpio[GPIO_REG_GPSET0] = setMask;
+      if(clrMask != 0) _wiringPiGpio[GPIO_REG_GPCLR0] = clrMask;
+   }
+   else {
+      for(const IoPin &output : _outputs){
+         if((changed & output.mask) != 0 || output.mask == 0) {
+            digitalWrite(output.pin, static_cast<int>(io.Get(output.handle)));
+         } // end if 
+      } // end for 
+   } // end if 
+
+   _outputLevels = levels;
+   _outputsWritten = true;
 
    return ret;
 } // end ReadInputs
@@ -3,6 +3,8 @@
 /// date: 07-11-2020
 /// description: 
 /// revision: 9-16-2021, add mutex to guard 
+/// revision: 10-17-2026, input edge events from the gpio character device
+/// revision: 10-17-2026, bank 0 register snapshot read and masked output write
 
 
 // header guard
@@ -14,7 +16,9 @@
 #include <set>
 #include <vector>
 #include <mutex>
+#include <cstdint>
 #include <boost/assert.hpp> // may not be in boost namespace
+#include <boost/circular_buffer.hpp>
 
 #include "CommonDef.h"
 #include "Util.h"
@@ -22,6 +26,26 @@
 using namespace std;
 
 
+// the Pi 4 40 pin header lines
+const string GPIO_CHIP_PATH = "/dev/gpiochip0";
+
+// 32 bit word offsets of the bank 0 registers in the wiringPi gpio mapping
+const unsigned GPIO_REG_GPSET0 = 7;     /// write 1 bits to set outputs
+const unsigned GPIO_REG_GPCLR0 = 10;    /// write 1 bits to clear outputs
+const unsigned GPIO_REG_GPLEV0 = 13;    /// level of gpio 0 - 31
+
+// edges held between ReadEdges() and PopEdge(), the oldest is dropped when full
+const size_t IO_EDGE_QUEUE_SIZE = 64;
+
+// an input edge from the kernel, timestampNs is CLOCK_MONOTONIC
+// at the interrupt, not when the program read it
+struct IoEdge {
+   IoHandle handle;
+   unsigned value;         /// input level after the edge, 1 rising, 0 falling
+   uint64_t timestampNs;
+}; // end struct
+
+
 class DigitalIO {
 
 public: 
@@ -31,8 +55,30 @@ public:
    int SetIoPoints(const vector<IoConfig> &dioVect);
    int ConfigureHardware();
 
+   // resolve the names in values to pins, call once before ReadAll(),
+   // SetOutputs() and EnableEdgeEvents() with the same set of names
+   int BindIoValues(const IoValues &values);
+
+   // ReadAll() reads every input from one GPLEV0 sample, SetOutputs() 
+   // writes only the changed outputs with one GPSET0 and one GPCLR0 write.
+   // falls back to digitalRead()/digitalWrite() if a pin is not in bank 0
    int ReadAll(IoValues &values);
    int SetOutputs(const IoValues &values);
+   bool IsBulkIo() { return _bulkIo; }
+
+   // request rising and falling edge events for all the inputs through the
+   // gpio character device, the kernel timestamps and queues each edge.
+   // wait on GetEdgeFd() (EPOLLIN) then call ReadEdges()
+   int EnableEdgeEvents(unsigned debounceUs);
+   void DisableEdgeEvents();
+   int GetEdgeFd() { return _edgeFd; }
+
+   // move the pending edges from the kernel to the edge queue, never blocks
+   int ReadEdges();
+
+   // oldest edge first, false when the queue is empty
+   bool PopEdge(IoEdge &edge);
+   uint64_t GetDroppedEdges() { return _droppedEdges; }
 
    string GetErrorStr(){ return _errorStr; }
 
@@ -42,6 +88,26 @@ private:
    string _errorStr; 
    mutex _mtx;
 
+   // pins by IoValues handle, filled by BindIoValues()
+   struct IoPin {
+      IoHandle handle;
+      unsigned pin;
+      InputResistorMode mode;
+      uint32_t mask;          /// 1 << bcm gpio number
+   }; // end struct
+   vector<IoPin> _inputs;
+   vector<IoPin> _outputs;
+   size_t _boundSize;
+
+   bool _bulkIo;
+   bool _outputsWritten;      /// false until the first SetOutputs() writes every output
+   uint32_t _outputLevels;    /// last written output levels, by gpio mask
+
+   int _edgeFd;
+   map<unsigned, IoHandle> _edgeHandles;  /// gpio line offset to io handle
+   boost::circular_buffer<IoEdge> _edges;
+   uint64_t _droppedEdges;
+
    int GetPinForName(const string &name, unsigned &pin);
 
 }; // end class
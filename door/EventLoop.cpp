@@ -0,0 +1,217 @@
+#include "EventLoop.h"
+#include <cerrno>
+#include <cstring>
+#include <array>
+
+
+EventLoop::EventLoop() {
+   _epollFd = -1;
+   _tickFd = -1;
+   _wakeFd = -1;
+   _tickMS = 0;
+} // end ctor
+
+
+EventLoop::~EventLoop() {
+   Close();
+} // end dtor
+
+
+int EventLoop::Open() {
+
+   if(_epollFd >= 0) return 0;
+
+   _epollFd = epoll_create1(EPOLL_CLOEXEC);
+   if(_epollFd < 0) {
+      _errorStr = string("epoll_create1() failed: ") + strerror(errno);
+      return -1;
+   } // end if
+
+   _tickFd = timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK | TFD_CLOEXEC);
+   if(_tickFd < 0) {
+      _errorStr = string("timerfd_create() failed: ") + strerror(errno);
+      Close();
+      return -1;
+   } // end if
+
+   _wakeFd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+   if(_wakeFd < 0) {
+      _errorStr = string("eventfd() failed: ") + strerror(errno);
+      Close();
+      return -1;
+   } // end if
+
+   // Wait() checks these two fds itself, so no handlers
+   if(Add(_tickFd, EPOLLIN, nullptr) != 0 || Add(_wakeFd, EPOLLIN, nullptr) != 0) {
+      Close();
+      return -1;
+   } // end if
+
+   return 0;
+} // end Open
+
+
+void EventLoop::Close() {
+
+   if(_tickFd >= 0) close(_tickFd);
+   if(_wakeFd >= 0) close(_wakeFd);
+   if(_epollFd >= 0) close(_epollFd);
+
+   _tickFd = -1;
+   _wakeFd = -1;
+   _epollFd = -1;
+   _tickMS = 0;
+   _handlers.clear();
+
+} // end Close
+
+
+int EventLoop::Add(int fd, uint32_t events, Handler handler) {
+
+   if(_epollFd < 0) {
+      _errorStr = "event loop is not open";
+      return -1;
+   } // end if
+
+   epoll_event ev{};
+   ev.events = events;
+   ev.data.fd = fd;
+
+   if(epoll_ctl(_epollFd, EPOLL_CTL_ADD, fd, &ev) < 0) {
+      _errorStr = string("epoll_ctl() add failed: ") + strerror(errno);
+      return -1;
+   } // end if
+
+   _handlers[fd] = handler;
+   return 0;
+} // end Add
+
+
+int EventLoop::Remove(int fd) {
+
+   if(_epollFd < 0) return 0;
+
+   _handlers.erase(fd);
+
+   if(epoll_ctl(_epollFd, EPOLL_CTL_DEL, fd, nullptr) < 0) {
+      _errorStr = string("epoll_ctl() delete failed: ") + strerror(errno);
+      return -1;
+   } // end if
+
+   return 0;
+} // end Remove
+
+
+int EventLoop::Modify(int fd, uint32_t events) {
+
+   if(_epollFd < 0) {
+      _errorStr = "event loop is not open";
+      return -1;
+   } // end if
+
+   epoll_event ev{};
+   ev.events = events;
+   ev.data.fd = fd;
+
+   if(epoll_ctl(_epollFd, EPOLL_CTL_MOD, fd, &ev) < 0) {
+      _errorStr = string("epoll_ctl() modify failed: ") + strerror(errno);
+      return -1;
+   } // end if
+
+   return 0;
+} // end Modify
+
+
+int EventLoop::SetTickMS(unsigned ms) {
+
+   if(_tickFd < 0) {
+      _errorStr = "event loop is not open";
+      return -1;
+   } // end if
+
+   if(ms == _tickMS) return 0;
+
+   // first expiry one period from now, then every period
+   itimerspec its{};
+   its.it_interval.tv_sec = ms / 1000;
+   its.it_interval.tv_nsec = static_cast<long>(ms % 1000) * 1000000L;
+   its.it_value = its.it_interval;
+
+   if(timerfd_settime(_tickFd, 0, &its, nullptr) < 0) {
+      _errorStr = string("timerfd_settime() failed: ") + strerror(errno);
+      return -1;
+   } // end if
+
+   _tickMS = ms;
+   return 0;
+} // end SetTickMS
+
+
+int EventLoop::Wait(bool &ticked) {
+   array<epoll_event, EVENT_LOOP_MAX_EVENTS> events;
+
+   ticked = false;
+
+   if(_epollFd < 0) {
+      _errorStr = "event loop is not open";
+      return -1;
+   } // end if
+
+   int count = epoll_wait(_epollFd, events.data(), static_cast<int>(events.size()), -1);
+   if(count < 0) {
+
+      // a signal is not an error, just run the loop body again
+      if(errno == EINTR) return 0;
+
+      _errorStr = string("epoll_wait() failed: ") + strerror(errno);
+      return -1;
+   } // end if
+
+   for(int i = 0; i < count; ++i) {
+      int fd = events[i].data.fd;
+
+      if(fd == _tickFd) {
+         DrainCounter(_tickFd);
+         ticked = true;
+      }
+      else if(fd == _wakeFd) {
+         DrainCounter(_wakeFd);
+      }
+      else {
+         // a handler may Remove() its own fd, so copy it out first
+         auto it = _handlers.find(fd);
+         if(it != _handlers.end() && it->second) {
+            Handler handler = it->second;
+            handler(events[i].events);
+         } // end if
+      } // end if
+
+   } // end for
+
+   return count;
+} // end Wait
+
+
+int EventLoop::Wakeup() {
+   uint64_t one = 1;
+
+   if(_wakeFd < 0) return -1;
+
+   // the eventfd counter saturates long before it matters, a full
+   // counter still leaves the fd readable
+   if(write(_wakeFd, &one, sizeof(one)) != sizeof(one) && errno != EAGAIN) {
+      return -1;
+   } // end if
+
+   return 0;
+} // end Wakeup
+
+
+// read the 8 byte counter of a timerfd or eventfd so it stops being readable
+void EventLoop::DrainCounter(int fd) {
+   uint64_t value = 0;
+
+   ssize_t result = read(fd, &value, sizeof(value));
+   (void)result;
+
+} // end DrainCounter
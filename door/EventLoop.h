@@ -0,0 +1,80 @@
+/// file: EventLoop.h header for EventLoop class
+/// author: Bennett Cook
+/// date: 10-17-2026
+/// description: a small epoll reactor for the main loop. The loop blocks
+/// in Wait() until a registered fd is ready, the periodic tick timerfd
+/// expires or another thread calls Wakeup(). The tick bounds the worst
+/// case reaction time, the fds (stdin, the user input watch, gpio line
+/// events) wake the loop as soon as something happens.
+
+
+// header guard
+#ifndef EVENTLOOP_H
+#define EVENTLOOP_H
+
+#include <unistd.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/timerfd.h>
+#include <cstdint>
+#include <string>
+#include <map>
+#include <functional>
+#include <boost/core/noncopyable.hpp>
+
+using namespace std;
+
+
+// most ready fds handled by one Wait()
+const int EVENT_LOOP_MAX_EVENTS = 16;
+
+
+class EventLoop : private boost::noncopyable {
+public:
+
+   // called from Wait() with the epoll events of the fd
+   using Handler = std::function<void(uint32_t events)>;
+
+   EventLoop();
+   ~EventLoop();
+
+   // create the epoll, tick timerfd and wakeup eventfd
+   int Open();
+   void Close();
+
+   // watch fd for events (EPOLLIN...), the handler runs on the Wait() thread,
+   // a null handler only wakes the loop
+   int Add(int fd, uint32_t events, Handler handler);
+   int Remove(int fd);
+
+   // change the events watched on an added fd, the handler stays
+   int Modify(int fd, uint32_t events);
+
+   // periodic tick in ms, 0 stops the tick. Re-arms only on a new value
+   int SetTickMS(unsigned ms);
+   unsigned GetTickMS() { return _tickMS; }
+
+   // block until an fd, the tick or Wakeup(), ticked is true if the
+   // tick expired. return the number of events handled, -1 on error
+   int Wait(bool &ticked);
+
+   // safe to call from any thread
+   int Wakeup();
+
+   string GetErrorStr() { return _errorStr; }
+
+private:
+
+   int _epollFd;
+   int _tickFd;
+   int _wakeFd;
+   unsigned _tickMS;
+   map<int, Handler> _handlers;
+   string _errorStr;
+
+   static void DrainCounter(int fd);
+
+}; // end class
+
+
+#endif // end header guard
@@ -0,0 +1,325 @@
+#include "HttpServer.h"
+#include <unistd.h>
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
+#include <cerrno>
+#include <cstring>
+#include <cstdlib>
+#include <strings.h>
+
+
+HttpServer::HttpServer(EventLoop &loop) :
+   _loop(loop), _listenFd{-1} {
+} // end ctor
+
+
+HttpServer::~HttpServer() {
+   Close();
+} // end dtor
+
+
+int HttpServer::Open(const string &address, uint16_t port) {
+
+   if(_listenFd >= 0) return 0;
+
+   sockaddr_in addr{};
+   addr.sin_family = AF_INET;
+   addr.sin_port = htons(port);
+   if(inet_pton(AF_INET, address.c_str(), &addr.sin_addr) != 1) {
+      _errorStr = "http address is not an ipv4 address: " + address;
+      return -1;
+   } // end if
+
+   _listenFd = socket(AF_INET, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+   if(_listenFd < 0) {
+      _errorStr = string("socket() failed: ") + strerror(errno);
+      return -1;
+   } // end if
+
+   // a restart doesn't wait out the old connections in TIME_WAIT
+   int one = 1;
+   setsockopt(_listenFd, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+
+   if(bind(_listenFd, reinterpret_cast<sockaddr *>(&addr), sizeof(addr)) < 0) {
+      _errorStr = "bind() " + address + ":" + to_string(port) + " failed: " + strerror(errno);
+      Close();
+      return -1;
+   } // end if
+
+   if(listen(_listenFd, static_cast<int>(HTTP_MAX_CLIENTS)) < 0) {
+      _errorStr = string("listen() failed: ") + strerror(errno);
+      Close();
+      return -1;
+   } // end if
+
+   if(_loop.Add(_listenFd, EPOLLIN, [this](uint32_t) { this->OnAccept(); }) != 0) {
+      _errorStr = _loop.GetErrorStr();
+      Close();
+      return -1;
+   } // end if
+
+   return 0;
+} // end Open
+
+
+void HttpServer::Close() {
+
+   while(_clients.empty() == false) CloseClient(_clients.begin()->first);
+
+   if(_listenFd < 0) return;
+
+   _loop.Remove(_listenFd);
+   close(_listenFd);
+   _listenFd = -1;
+
+} // end Close
+
+
+void HttpServer::AddRoute(const string &method, const string &path, Handler handler) {
+   _routes[method + " " + path] = handler;
+} // end AddRoute
+
+
+void HttpServer::CloseIdle() {
+   auto now = chrono::steady_clock::now();
+   vector<int> idle;
+
+   for(auto &[fd, client] : _clients) {
+      if(now - client.start > chrono::milliseconds(HTTP_CLIENT_TIMEOUT_MS)) idle.push_back(fd);
+   } // end for
+
+   for(int fd : idle) CloseClient(fd);
+
+} // end CloseIdle
+
+
+void HttpServer::OnAccept() {
+
+   while(true) {
+      int fd = accept4(_listenFd, nullptr, nullptr, SOCK_NONBLOCK | SOCK_CLOEXEC);
+      if(fd < 0) {
+         if(errno == EINTR) continue;
+         break;
+      } // end if
+
+      if(_clients.size() >= HTTP_MAX_CLIENTS) {
+         close(fd);
+         continue;
+      } // end if
+
+      if(_loop.Add(fd, EPOLLIN | EPOLLRDHUP, [this, fd](uint32_t events) { this->OnClient(fd, events); }) != 0) {
+         close(fd);
+         continue;
+      } // end if
+
+      Client &client = _clients[fd];
+      client.sent = 0;
+      client.start = chrono::steady_clock::now();
+   } // end while
+
+} // end OnAccept
+
+
+void HttpServer::OnClient(int fd, uint32_t events) {
+
+   auto it = _clients.find(fd);
+   if(it == _clients.end()) return;
+   Client &client = it->second;
+
+   if(events & EPOLLERR) {
+      CloseClient(fd);
+      return;
+   } // end if
+
+   // the response is being sent, only the socket space matters
+   if(client.out.empty() == false) {
+      if(events & (EPOLLOUT | EPOLLHUP)) Send(fd, client);
+      return;
+   } // end if
+
+   bool closed = false;
+   while(true) {
+      char buf[1024];
+      ssize_t len = recv(fd, buf, sizeof(buf), 0);
+      if(len > 0) {
+         client.in.append(buf, static_cast<size_t>(len));
+         if(client.in.size() > HTTP_MAX_REQUEST) break;
+         continue;
+      } // end if
+
+      if(len == 0) closed = true;
+      else if(errno == EINTR) continue;
+      else if(errno != EAGAIN && errno != EWOULDBLOCK) closed = true;
+      break;
+   } // end while
+
+   HttpRequest request;
+   int parsed = client.in.size() > HTTP_MAX_REQUEST ? -1 : ParseRequest(client.in, request);
+
+   if(parsed == 0) {
+      // a client that stops sending before the end of its request gets nothing
+      if(closed == true) CloseClient(fd);
+      return;
+   } // end if
+
+   HttpResponse response{200, "application/json", ""};
+
+   if(parsed < 0) {
+      response.status = client.in.size() > HTTP_MAX_REQUEST ? 413 : 400;
+   }
+   else {
+      auto route = _routes.find(request.method + " " + request.path);
+      if(route != _routes.end()) {
+         route->second(request, response);
+      }
+      else {
+         // the path with another method is a 405
+         bool pathFound = false;
+         for(auto &[key, handler] : _routes) {
+            if(key.compare(key.find(' ') + 1, string::npos, request.path) == 0) pathFound = true;
+         } // end for
+         response.status = pathFound == true ? 405 : 404;
+      } // end if
+   } // end if
+
+   if(response.status != 200 && response.body.empty() == true) {
+      response.body = "{\"error\":\"" + StatusText(response.status) + "\"}";
+   } // end if
+
+   client.out = "HTTP/1.0 " + to_string(response.status) + " " + StatusText(response.status) + "\r\n" +
+                "Content-Type: " + response.contentType + "\r\n" +
+                "Content-Length: " + to_string(response.body.size()) + "\r\n" +
+                "Cache-Control: no-store\r\n" +
+                "Connection: close\r\n\r\n" + response.body;
+   client.sent = 0;
+   client.in.clear();
+
+   Send(fd, client);
+
+} // end OnClient
+
+
+void HttpServer::Send(int fd, Client &client) {
+
+   while(client.sent < client.out.size()) {
+      ssize_t len = send(fd, client.out.data() + client.sent, client.out.size() - client.sent, MSG_NOSIGNAL);
+      if(len > 0) {
+         client.sent += static_cast<size_t>(len);
+         continue;
+      } // end if
+
+      if(len < 0 && errno == EINTR) continue;
+
+      // a full socket, finish when it is writable again. No EPOLLRDHUP, a
+      // half closed peer still reads the response and the level triggered
+      // event would fire on every Wait() until then
+      if(len < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+         if(_loop.Modify(fd, EPOLLOUT) != 0) CloseClient(fd);
+         return;
+      } // end if
+
+      break;
+   } // end while
+
+   CloseClient(fd);
+
+} // end Send
+
+
+void HttpServer::CloseClient(int fd) {
+
+   _loop.Remove(fd);
+   close(fd);
+   _clients.erase(fd);
+
+} // end CloseClient
+
+
+int HttpServer::ParseRequest(const string &in, HttpRequest &request) {
+
+   size_t headerEnd = in.find("\r\n\r\n");
+   if(headerEnd == string::npos) return 0;
+
+   // "GET /path?query HTTP/1.1"
+   size_t lineEnd = in.find("\r\n");
+   string line = in.substr(0, lineEnd);
+   size_t sp1 = line.find(' ');
+   if(sp1 == string::npos) return -1;
+   size_t sp2 = line.find(' ', sp1 + 1);
+   if(sp2 == string::npos) return -1;
+
+   request.method = line.substr(0, sp1);
+   string target = line.substr(sp1 + 1, sp2 - sp1 - 1);
+   if(target.empty() == true || target[0] != '/') return -1;
+
+   size_t question = target.find('?');
+   request.path = target.substr(0, question);
+   request.query = question == string::npos ? "" : target.substr(question + 1);
+
+   // only the body length matters of the headers
+   size_t contentLength = 0;
+   size_t pos = lineEnd + 2;
+   while(pos < headerEnd) {
+      size_t end = in.find("\r\n", pos);
+      string header = in.substr(pos, end - pos);
+      const char name[] = "content-length:";
+      if(strncasecmp(header.c_str(), name, sizeof(name) - 1) == 0) {
+         contentLength = strtoul(header.c_str() + sizeof(name) - 1, nullptr, 10);
+      } // end if
+      pos = end + 2;
+   } // end while
+
+   size_t bodyStart = headerEnd + 4;
+   if(contentLength > HTTP_MAX_REQUEST) return -1;
+   if(in.size() < bodyStart + contentLength) return 0;
+
+   request.body = in.substr(bodyStart, contentLength);
+   return 1;
+} // end ParseRequest
+
+
+string HttpServer::StatusText(int status) {
+   switch(status) {
+   case 200: return "OK";
+   case 400: return "Bad Request";
+   case 404: return "Not Found";
+   case 405: return "Method Not Allowed";
+   case 413: return "Payload Too Large";
+   case 503: return "Service Unavailable";
+   } // end switch
+
+   return "Error";
+} // end StatusText
+
+
+string HttpFormValue(const string &form, const string &name) {
+   size_t pos = 0;
+
+   while(pos <= form.size()) {
+      size_t end = form.find('&', pos);
+      if(end == string::npos) end = form.size();
+
+      size_t equal = form.find('=', pos);
+      if(equal != string::npos && equal < end && form.compare(pos, equal - pos, name) == 0) {
+         string value;
+         for(size_t i = equal + 1; i < end; ++i) {
+            if(form[i] == '+') {
+               value += ' ';
+            }
+            else if(form[i] == '%' && i + 2 < end) {
+               value += static_cast<char>(strtol(form.substr(i + 1, 2).c_str(), nullptr, 16));
+               i += 2;
+            }
+            else {
+               value += form[i];
+            } // end if
+         } // end for
+         return value;
+      } // end if
+
+      pos = end + 1;
+   } // end while
+
+   return "";
+} // end HttpFormValue
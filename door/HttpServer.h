@@ -0,0 +1,114 @@
+/// file: HttpServer.h header for HttpServer class
+/// author: Bennett Cook
+/// date: 10-17-2026
+/// description: a small non-blocking HTTP/1.0 server on the main EventLoop,
+/// for json status and commands on the local network. The listen socket
+/// and the clients are fds of the loop, so a request is answered on the
+/// main thread in the Wait() that sees it, no thread and no locks. A
+/// route is a method and an exact path, its handler fills the response.
+/// Each client sends one request and the connection closes after the
+/// response. Only what the door needs: no keep alive, no chunked bodies,
+/// a request is at most HTTP_MAX_REQUEST bytes.
+/// usage: curl http://127.0.0.1:8081/status
+///        curl -d cmd=u http://127.0.0.1:8081/command
+
+
+// header guard
+#ifndef HTTPSERVER_H
+#define HTTPSERVER_H
+
+#include <cstdint>
+#include <string>
+#include <map>
+#include <vector>
+#include <chrono>
+#include <functional>
+#include <boost/core/noncopyable.hpp>
+
+#include "EventLoop.h"
+
+using namespace std;
+
+
+// clients served at once, more are closed at accept
+const size_t HTTP_MAX_CLIENTS = 8;
+
+// request line, headers and body
+const size_t HTTP_MAX_REQUEST = 4096;
+
+// a client that hasn't sent its request or read the response in this
+// time is closed by CloseIdle()
+const unsigned HTTP_CLIENT_TIMEOUT_MS = 5000;
+
+
+struct HttpRequest {
+   string method;
+   string path;
+   string query;     // after the ?, not decoded
+   string body;
+}; // end struct
+
+
+struct HttpResponse {
+   int status;
+   string contentType;
+   string body;
+}; // end struct
+
+
+class HttpServer : private boost::noncopyable {
+public:
+
+   // fills the response, it starts as 200 application/json, empty body
+   using Handler = std::function<void(const HttpRequest &request, HttpResponse &response)>;
+
+   HttpServer(EventLoop &loop);
+   ~HttpServer();
+
+   // listen on address:port and add the socket to the loop
+   int Open(const string &address, uint16_t port);
+   void Close();
+
+   // method is "GET" or "POST", path is matched exactly
+   void AddRoute(const string &method, const string &path, Handler handler);
+
+   // close the clients past HTTP_CLIENT_TIMEOUT_MS, call it every loop pass
+   void CloseIdle();
+
+   string GetErrorStr() { return _errorStr; }
+
+private:
+
+   struct Client {
+      string in;
+      string out;
+      size_t sent;
+      chrono::steady_clock::time_point start;
+   }; // end struct
+
+   EventLoop &_loop;
+   int _listenFd;
+   map<int, Client> _clients;
+   map<string, Handler> _routes;   // "<method> <path>"
+   string _errorStr;
+
+   void OnAccept();
+   void OnClient(int fd, uint32_t events);
+   void Respond(int fd, Client &client);
+   void Send(int fd, Client &client);
+   void CloseClient(int fd);
+
+   // 1 when in holds the whole request and it's parsed, 0 when more is
+   // needed, -1 when it's malformed
+   static int ParseRequest(const string &in, HttpRequest &request);
+   static string StatusText(int status);
+
+}; // end class
+
+
+// the value of name in a query or form body "a=1&b=2", "" if not there,
+// + and %xx are decoded
+string HttpFormValue(const string &form, const string &name);
+
+
+#endif // end header guard
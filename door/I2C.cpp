@@ -1,14 +1,16 @@
-/// file: TempHumid.h header for TempHumid class  
+/// file: I2C.cpp the I2C base class  
 /// author: Bennett Cook
 /// date: 01-30-2021
 /// description: 
 
 
 #include "I2C.h"
+#include <cerrno>
+#include <cstring>
 
 
-I2C::I2C(unsigned char deviceAddress){
-   _bus = "/dev/i2c-1";
+I2C::I2C(unsigned char deviceAddress, const string &bus) : 
+   _bus(I2cBus::Instance(bus)) {
    _deviceAddress = deviceAddress;
 } // end ctor 
 
@@ -19,28 +21,44 @@ I2C::~I2C(){
 
 int I2C::Open(){
 
-   int ret = 0;
+   if(_bus.Open() != 0) {
+      _error = "open i2c bus " + _bus.GetPath() + " failed: " + strerror(errno);
+      return -1;
+   } // end if 
 
-   if((_fd = open(_bus.c_str(), O_RDWR)) < 0) {
-		_error = "open i2c bus failed";
-		return -1;
-	} // end if 
-   
-	// set the I2C device as slave
-	ioctl(_fd, I2C_SLAVE, _deviceAddress);
-
-   return ret;
+   return 0;
 } // end Open
 
-int I2C::Close(){
 
-   int ret = 0;
+int I2C::WriteBytes(const unsigned char *data, size_t length, const char *what) {
+
+   if(_bus.Write(_deviceAddress, data, length) != 0) {
+      _error = string(what) + ": " + strerror(errno);
+      return -1;
+   } // end if 
+
+   return 0;
+} // end WriteBytes
+
+
+int I2C::ReadBytes(unsigned char *data, size_t length, const char *what) {
+
+   if(_bus.Read(_deviceAddress, data, length) != 0) {
+      _error = string(what) + ": " + strerror(errno);
+      return -1;
+   } // end if 
+
+   return 0;
+} // end ReadBytes
+
+
+int I2C::WriteRead(const unsigned char *out, size_t outLength, 
+                   unsigned char *in, size_t inLength, const char *what) {
 
-   if(close(_fd) < 0) {
-		_error = "close i2c bus failed";
-		return -1;
-	} // end if 
-   
-   return ret;
-} // end Close
+   if(_bus.WriteRead(_deviceAddress, out, outLength, in, inLength) != 0) {
+      _error = string(what) + ": " + strerror(errno);
+      return -1;
+   } // end if 
 
+   return 0;
+} // end WriteRead
@@ -1,7 +1,9 @@
 /// file: I2C.h header for I2C base class  
 /// author: Bennett Cook
 /// date: 01-31-2021
-/// description: 
+/// description: base of the i2c devices, the transfers go through the
+/// shared I2cBus so the bus fd stays open and the devices don't interleave.
+/// The helpers set _error from errno on a failed transfer.
 
 
 // header guard
@@ -12,32 +14,34 @@
 #include <iostream>
 #include <iomanip>
 #include <string>
-#include <fcntl.h>
 
-#include <unistd.h>
-#include <linux/i2c-dev.h>
-#include <sys/ioctl.h>
+#include "I2cBus.h"
 
 
 using namespace std;
 
 class I2C {
 public:
-   I2C(unsigned char deviceAddress);
+   I2C(unsigned char deviceAddress, const string &bus = I2C_DEFAULT_BUS);
    virtual ~I2C();
 
+   // opens the shared bus if it isn't open, the bus stays open
    int Open();
-   int Close();
 
    string GetErrorStr() {return _error;}
 
  protected:
 
-	int _fd;
+   I2cBus &_bus;
    string _error;
-   string _bus;
    unsigned char _deviceAddress;
 
+   // one transaction each, return 0 or -1 with _error set to what: errno
+   int WriteBytes(const unsigned char *data, size_t length, const char *what);
+   int ReadBytes(unsigned char *data, size_t length, const char *what);
+   int WriteRead(const unsigned char *out, size_t outLength, 
+                 unsigned char *in, size_t inLength, const char *what);
+
 }; // end class
 
 #endif  // end header guard
@@ -0,0 +1,117 @@
+#include "I2cBus.h"
+#include <map>
+#include <memory>
+#include <cerrno>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/ioctl.h>
+#include <linux/i2c.h>
+#include <linux/i2c-dev.h>
+
+
+I2cBus &I2cBus::Instance(const string &path) {
+   static mutex busesMutex;
+   static map<string, unique_ptr<I2cBus>> buses;
+
+   lock_guard<mutex> lock(busesMutex);
+
+   auto &bus = buses[path];
+   if(bus == nullptr) bus.reset(new I2cBus(path));
+
+   return *bus;
+} // end Instance
+
+
+I2cBus::I2cBus(const string &path) {
+   _path = path;
+   _fd = -1;
+} // end ctor
+
+
+I2cBus::~I2cBus() {
+   Close();
+} // end dtor
+
+
+int I2cBus::Open() {
+   lock_guard<mutex> lock(_mutex);
+   return OpenLocked();
+} // end Open
+
+
+void I2cBus::Close() {
+   lock_guard<mutex> lock(_mutex);
+
+   if(_fd >= 0) close(_fd);
+   _fd = -1;
+
+} // end Close
+
+
+int I2cBus::Write(uint8_t address, const uint8_t *data, size_t length) {
+   return Transfer(address, data, length, nullptr, 0);
+} // end Write
+
+
+int I2cBus::Read(uint8_t address, uint8_t *data, size_t length) {
+   return Transfer(address, nullptr, 0, data, length);
+} // end Read
+
+
+int I2cBus::WriteRead(uint8_t address, const uint8_t *out, size_t outLength, uint8_t *in, size_t inLength) {
+   return Transfer(address, out, outLength, in, inLength);
+} // end WriteRead
+
+
+int I2cBus::OpenLocked() {
+
+   if(_fd >= 0) return 0;
+
+   _fd = open(_path.c_str(), O_RDWR | O_CLOEXEC);
+   return _fd >= 0 ? 0 : -1;
+} // end OpenLocked
+
+
+// the write message then the read message, either can be empty
+int I2cBus::Transfer(uint8_t address, const uint8_t *out, size_t outLength, uint8_t *in, size_t inLength) {
+
+   i2c_msg msgs[2];
+   unsigned count = 0;
+
+   if(outLength > 0) {
+      msgs[count].addr = address;
+      msgs[count].flags = 0;
+      msgs[count].len = static_cast<uint16_t>(outLength);
+      msgs[count].buf = const_cast<uint8_t *>(out);
+      ++count;
+   } // end if
+
+   if(inLength > 0) {
+      msgs[count].addr = address;
+      msgs[count].flags = I2C_M_RD;
+      msgs[count].len = static_cast<uint16_t>(inLength);
+      msgs[count].buf = in;
+      ++count;
+   } // end if
+
+   if(count == 0) return 0;
+
+   i2c_rdwr_ioctl_data data;
+   data.msgs = msgs;
+   data.nmsgs = count;
+
+   lock_guard<mutex> lock(_mutex);
+
+   if(OpenLocked() != 0) return -1;
+
+   // returns the number of messages done
+   int result = ioctl(_fd, I2C_RDWR, &data);
+   if(result < 0) return -1;
+
+   if(result != static_cast<int>(count)) {
+      errno = EIO;
+      return -1;
+   } // end if
+
+   return 0;
+} // end Transfer
@@ -0,0 +1,63 @@
+/// file: I2cBus.h header for I2cBus class
+/// author: Bennett Cook
+/// date: 10-17-2026
+/// description: one open fd per i2c bus shared by every device on it.
+/// The fd is opened on the first transfer and stays open, a transfer is a
+/// single ioctl(I2C_RDWR) with the device address in each message, so no
+/// I2C_SLAVE per device and a register read (write the register then read
+/// with a repeated start) is one syscall. A mutex serializes the transfers
+/// of all the devices from any thread (the ReaderPool workers).
+/// usage: uint8_t id; I2cBus::Instance().WriteRead(0x29, &reg, 1, &id, 1);
+
+
+// header guard
+#ifndef I2CBUS_H
+#define I2CBUS_H
+
+#include <cstdint>
+#include <cstddef>
+#include <string>
+#include <mutex>
+#include <boost/core/noncopyable.hpp>
+
+using namespace std;
+
+
+const string I2C_DEFAULT_BUS = "/dev/i2c-1";
+
+
+class I2cBus : private boost::noncopyable {
+public:
+
+   // the bus for path, made on the first call, never destroyed
+   static I2cBus &Instance(const string &path = I2C_DEFAULT_BUS);
+
+   ~I2cBus();
+
+   // opens the bus if it isn't, done by the transfers too
+   int Open();
+   void Close();
+
+   // all return 0 or -1 with errno set, the messages go out in one
+   // transaction with repeated starts
+   int Write(uint8_t address, const uint8_t *data, size_t length);
+   int Read(uint8_t address, uint8_t *data, size_t length);
+   int WriteRead(uint8_t address, const uint8_t *out, size_t outLength, uint8_t *in, size_t inLength);
+
+   const string &GetPath() { return _path; }
+
+private:
+
+   explicit I2cBus(const string &path);
+
+   string _path;
+   int _fd;
+   mutex _mutex;
+
+   int OpenLocked();
+   int Transfer(uint8_t address, const uint8_t *out, size_t outLength, uint8_t *in, size_t inLength);
+
+}; // end class
+
+
+#endif // end header guard
@@ -0,0 +1,94 @@
+/// file: IoValues.h header for the IoValues class
+/// author: Bennett Cook
+/// date: 10-17-2026
+/// description: flat snapshot of the digital io values. The io names from
+/// the configuration are resolved once at startup into integer handles
+/// (the index of the name), after that reading or writing a value is a
+/// bit operation with no lookup and no allocation. The name based
+/// operator[] is kept as a thin layer for setup code.
+
+
+// header guard
+#ifndef IOVALUES_H
+#define IOVALUES_H
+
+#include <string>
+#include <vector>
+#include <bitset>
+#include <cstddef>
+
+using namespace std;
+
+
+// index of an io point in IoValues
+using IoHandle = unsigned;
+const IoHandle INVALID_IO_HANDLE = ~0u;
+
+// the Pi 40 pin header has fewer usable gpio than this
+const size_t MAX_IO_POINTS = 32;
+
+
+class IoValues {
+public:
+
+   // name layer for operator[], reads and writes the bit of one handle
+   class Reference {
+   public:
+      Reference(IoValues &io, IoHandle handle) : _io(io), _handle(handle) {}
+      operator unsigned() const { return _io.Get(_handle); }
+      Reference &operator=(unsigned value) { _io.Set(_handle, value); return *this; }
+   private:
+      IoValues &_io;
+      IoHandle _handle;
+   }; // end class
+
+   // add the name if new, return its handle, INVALID_IO_HANDLE when full
+   IoHandle Add(const string &name) {
+      IoHandle handle = Handle(name);
+      if(handle != INVALID_IO_HANDLE) return handle;
+
+      if(_names.size() >= MAX_IO_POINTS) return INVALID_IO_HANDLE;
+
+      _names.push_back(name);
+      return static_cast<IoHandle>(_names.size() - 1);
+   } // end Add
+
+   // resolve a name once, INVALID_IO_HANDLE if not found
+   IoHandle Handle(const string &name) const {
+      for(size_t i = 0; i < _names.size(); ++i) {
+         if(_names[i] == name) return static_cast<IoHandle>(i);
+      } // end for
+      return INVALID_IO_HANDLE;
+   } // end Handle
+
+   const string &Name(IoHandle handle) const { return _names[handle]; }
+   size_t Size() const { return _names.size(); }
+
+   // constant time access by handle, an invalid handle reads 0 and ignores writes
+   unsigned Get(IoHandle handle) const {
+      return (handle < MAX_IO_POINTS && _bits.test(handle) == true) ? 1u : 0u;
+   } // end Get
+
+   void Set(IoHandle handle, unsigned value) {
+      if(handle < MAX_IO_POINTS) _bits.set(handle, value != 0);
+   } // end Set
+
+   const bitset<MAX_IO_POINTS> &Bits() const { return _bits; }
+
+   // same as the old map, an unknown name is added with value 0
+   Reference operator[](const string &name) { return Reference(*this, Add(name)); }
+   unsigned operator[](const string &name) const { return Get(Handle(name)); }
+
+   // the handles are fixed after startup, so compare the values only
+   bool operator==(const IoValues &rhs) const { return _bits == rhs._bits; }
+   bool operator!=(const IoValues &rhs) const { return _bits != rhs._bits; }
+
+private:
+
+   vector<string> _names;
+   bitset<MAX_IO_POINTS> _bits;
+
+}; // end class
+
+
+#endif // end header guard
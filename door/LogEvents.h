@@ -0,0 +1,196 @@
+/// file: LogEvents.h the binary log record and the table of log events
+/// author: Bennett Cook
+/// date: 10-17-2026
+/// description: the Logger writes fixed 64 byte records, the record has
+/// the event id and the raw arguments, not text. The format string of
+/// each event is in LOG_EVENT_TABLE below, the logdecode tool includes
+/// this header to turn the records back into lines. Add new events at
+/// the end of the table so the ids in old log files keep their meaning.
+/// No program headers are included so the tool builds on its own.
+/// note: LogEvents.h doesn't use "using namespace std" so it is std:: here
+
+
+// header guard
+#ifndef LOGEVENTS_H
+#define LOGEVENTS_H
+
+#include <cstdint>
+#include <cstddef>
+#include <cstring>
+#include <string>
+#include <boost/format.hpp>
+
+
+// X(name, format) the format is boost::format style, %1% is the first arg
+#define LOG_EVENT_TABLE(X) \
+   X(Text,                 "%1%") \
+   X(ProgramStart,         "program start: %1%") \
+   X(ProgramStop,          "program stop") \
+   X(StateAction,          "state machine: %1%") \
+   X(MotorSpeed,           "motor speed: %1% hz") \
+   X(TimerSetup,           "SetupTimer: ret=%1% tm: %2%") \
+   X(TimerStart,           "StartTimer: ret=%1%") \
+   X(DoorState,            "door state: %1% decision: %2%") \
+   X(InputEdge,            "edge %1%=%2% latency %3%us") \
+   X(GpioReadError,        "read gpio error: %1%") \
+   X(UserInput,            "new user input: %1% seq %2%") \
+   X(DbRowDropped,         "database write error: %1% row dropped, queue full") \
+   X(SensorReadError,      "sensor read error: %1%") \
+   X(LogRecordsDropped,    "log: %1% records dropped, ring full") \
+   X(LightRange,           "light range %1%: gain %2%x, %3% ms") \
+   X(PwmError,             "pwm error: %1%")
+
+
+enum class LogEvent : uint16_t {
+#define LOG_EVENT_ENUM(name, format) name,
+   LOG_EVENT_TABLE(LOG_EVENT_ENUM)
+#undef LOG_EVENT_ENUM
+   Count
+}; // end enum
+
+
+inline const char *LogEventFormat(uint16_t id) {
+   static const char *formats[] = {
+#define LOG_EVENT_FORMAT(name, format) format,
+      LOG_EVENT_TABLE(LOG_EVENT_FORMAT)
+#undef LOG_EVENT_FORMAT
+   };
+
+   if(id >= static_cast<uint16_t>(LogEvent::Count)) return nullptr;
+   return formats[id];
+} // end LogEventFormat
+
+
+inline const char *LogEventName(uint16_t id) {
+   static const char *names[] = {
+#define LOG_EVENT_NAME(name, format) #name,
+      LOG_EVENT_TABLE(LOG_EVENT_NAME)
+#undef LOG_EVENT_NAME
+   };
+
+   if(id >= static_cast<uint16_t>(LogEvent::Count)) return "Unknown";
+   return names[id];
+} // end LogEventName
+
+
+enum class LogLevel : uint8_t {
+   Debug = 0,
+   Info,
+   Warn,
+   Error
+}; // end enum
+
+
+// type of each argument in a record
+enum class LogArg : uint8_t {
+   None = 0,
+   Int,        // int64_t
+   Uint,       // uint64_t
+   Double,     // double
+   Text        // nul terminated, (length + 8) / 8 slots
+}; // end enum
+
+
+const size_t LOG_RECORD_SIZE = 64;
+const size_t LOG_MAX_ARGS = 4;
+const size_t LOG_PAYLOAD_SLOTS = 6;
+const size_t LOG_PAYLOAD_SIZE = LOG_PAYLOAD_SLOTS * 8;
+
+
+// one log line, fixed size so the rings and the file need no framing.
+// args are 8 byte slots, a Text arg takes as many slots as its length
+// and nul need, a long text is cut to the slots that are left
+struct LogRecord {
+   uint64_t timestampNs;                  // CLOCK_REALTIME
+   uint16_t event;                        // LogEvent
+   uint8_t level;                         // LogLevel
+   uint8_t argCount;
+   uint8_t argTypes[LOG_MAX_ARGS];        // LogArg
+   unsigned char payload[LOG_PAYLOAD_SIZE];
+}; // end struct
+
+static_assert(sizeof(LogRecord) == LOG_RECORD_SIZE, "log record must be 64 bytes");
+
+
+// the text of a record, no time or level, an event the table doesn't 
+// know prints its id and its args
+inline std::string FormatLogRecord(const LogRecord &record) {
+   const char *format = LogEventFormat(record.event);
+   std::string unknown;
+
+   if(format == nullptr) {
+      unknown = "event " + std::to_string(record.event);
+      for(unsigned i = 0; i < record.argCount; ++i) unknown += " %" + std::to_string(i + 1) + "%";
+      format = unknown.c_str();
+   } // end if
+
+   // a table format with the wrong arg count still prints what it has
+   boost::format f{format};
+   f.exceptions(boost::io::all_error_bits ^ (boost::io::too_many_args_bit | boost::io::too_few_args_bit));
+
+   size_t slot = 0;
+   for(unsigned i = 0; i < record.argCount && i < LOG_MAX_ARGS && slot < LOG_PAYLOAD_SLOTS; ++i) {
+      const unsigned char *src = record.payload + slot * 8;
+
+      switch(static_cast<LogArg>(record.argTypes[i])) {
+      case LogArg::Int: {
+         int64_t value;
+         memcpy(&value, src, 8);
+         f % value;
+         ++slot;
+         break;
+      }
+      case LogArg::Uint: {
+         uint64_t value;
+         memcpy(&value, src, 8);
+         f % value;
+         ++slot;
+         break;
+      }
+      case LogArg::Double: {
+         double value;
+         memcpy(&value, src, 8);
+         f % value;
+         ++slot;
+         break;
+      }
+      case LogArg::Text: {
+         size_t room = (LOG_PAYLOAD_SLOTS - slot) * 8;
+         size_t length = strnlen(reinterpret_cast<const char *>(src), room);
+         f % std::string(reinterpret_cast<const char *>(src), length);
+         slot += (length + 8) / 8;
+         break;
+      }
+      default:
+         slot = LOG_PAYLOAD_SLOTS;
+         break;
+      } // end switch
+
+   } // end for
+
+   return f.str();
+} // end FormatLogRecord
+
+
+inline const char *LogLevelToString(uint8_t level) {
+   switch(static_cast<LogLevel>(level)) {
+   case LogLevel::Debug: return "DEBUG";
+   case LogLevel::Info: return "INFO";
+   case LogLevel::Warn: return "WARN";
+   case LogLevel::Error: return "ERROR";
+   } // end switch
+   return "?";
+} // end LogLevelToString
+
+
+// first bytes of every log file
+const char LOG_FILE_MAGIC[8] = {'C', 'O', 'O', 'P', 'L', 'O', 'G', '1'};
+
+struct LogFileHeader {
+   char magic[8];
+   uint32_t recordSize;
+   uint32_t eventCount;   // LogEvent::Count of the writer
+}; // end struct
+
+
+#endif // end header guard
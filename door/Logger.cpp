@@ -0,0 +1,241 @@
+#include "Logger.h"
+#include "PrintUtils.h"
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <filesystem>
+
+
+Logger &Logger::Instance() {
+   static Logger logger;
+   return logger;
+} // end Instance
+
+
+Logger::Logger() {
+   _enabled = false;
+   _level = LogLevel::Info;
+   _stop = false;
+   _maxBytes = 0;
+   _files = 1;
+   _fileBytes = 0;
+   _droppedReported = 0;
+} // end ctor
+
+
+Logger::~Logger() {
+   Close();
+} // end dtor
+
+
+int Logger::Open(const string &path, size_t maxBytes, unsigned files, LogLevel level) {
+
+   if(_writer.joinable() == true) {
+      _errorStr = "logger is already open";
+      return -1;
+   } // end if
+
+   _path = path;
+   _maxBytes = maxBytes > sizeof(LogFileHeader) + LOG_RECORD_SIZE ? maxBytes : sizeof(LogFileHeader) + LOG_RECORD_SIZE;
+   _files = files > 0 ? files : 1;
+
+   if(OpenFile() != 0) return -1;
+
+   _level = level;
+   _stop = false;
+   _writer = thread([this]() { this->WriterTask(); });
+   _enabled = true;
+
+   return 0;
+} // end Open
+
+
+void Logger::Close() {
+
+   if(_writer.joinable() == false) return;
+
+   // records pushed after this are dropped in Log()
+   _enabled = false;
+   _stop = true;
+   _writer.join();
+
+   _file.close();
+
+} // end Close
+
+
+uint64_t Logger::GetDropped() {
+   uint64_t dropped = 0;
+
+   lock_guard<mutex> lock(_ringsMutex);
+   for(auto &ring : _rings) dropped += ring->GetDropped();
+
+   return dropped;
+} // end GetDropped
+
+
+Logger::Ring *Logger::AddRing() {
+   lock_guard<mutex> lock(_ringsMutex);
+
+   _rings.push_back(make_unique<Ring>());
+   return _rings.back().get();
+} // end AddRing
+
+
+void Logger::WriterTask() {
+   vector<LogRecord> records;
+   records.reserve(LOG_RING_SIZE);
+
+   // one more pass after the stop so nothing pushed before Close() is lost
+   bool last = false;
+   while(last == false) {
+      last = _stop;
+
+      if(Drain(records) > 0) {
+         if(Write(records) != 0) {
+            cout << "log write error: " << _errorStr << endl;
+         } // end if
+      } // end if
+
+      if(last == false) this_thread::sleep_for(chrono::milliseconds(LOG_FLUSH_MS));
+   } // end while
+
+} // end WriterTask
+
+
+// move every ring into records in time order
+size_t Logger::Drain(vector<LogRecord> &records) {
+   LogRecord record;
+
+   records.clear();
+
+   {
+      lock_guard<mutex> lock(_ringsMutex);
+      for(auto &ring : _rings) {
+         while(ring->Pop(record) == true) records.push_back(record);
+      } // end for
+   }
+
+   // each ring is in order, sort to merge the threads
+   stable_sort(records.begin(), records.end(), [](const LogRecord &a, const LogRecord &b) {
+      return a.timestampNs < b.timestampNs;
+   });
+
+   // note the records lost since the last pass as a record of its own
+   uint64_t dropped = GetDropped();
+   if(dropped != _droppedReported) {
+      LogRecord lost{};
+      lost.timestampNs = NowNs();
+      lost.event = static_cast<uint16_t>(LogEvent::LogRecordsDropped);
+      lost.level = static_cast<uint8_t>(LogLevel::Warn);
+      lost.argCount = 1;
+      lost.argTypes[0] = static_cast<uint8_t>(LogArg::Uint);
+      uint64_t count = dropped - _droppedReported;
+      memcpy(lost.payload, &count, sizeof(count));
+      records.push_back(lost);
+      _droppedReported = dropped;
+   } // end if
+
+   return records.size();
+} // end Drain
+
+
+int Logger::Write(const vector<LogRecord> &records) {
+   bool echo = PrintEnabled();
+
+   for(const auto &record : records) {
+
+      if(_fileBytes + LOG_RECORD_SIZE > _maxBytes) {
+         if(Rotate() != 0) return -1;
+      } // end if
+
+      _file.write(reinterpret_cast<const char *>(&record), LOG_RECORD_SIZE);
+      _fileBytes += LOG_RECORD_SIZE;
+
+      if(echo == true) cout << FormatLogRecord(record) << '\n';
+   } // end for
+
+   if(echo == true) cout.flush();
+
+   _file.flush();
+   if(_file.good() == false) {
+      _errorStr = "write to " + _path + " failed";
+      return -1;
+   } // end if
+
+   return 0;
+} // end Write
+
+
+// open the log for append, a new or foreign file gets the header
+int Logger::OpenFile() {
+   error_code ec;
+
+   _file.close();
+   _file.clear();
+
+   size_t size = filesystem::exists(_path, ec) == true ? filesystem::file_size(_path, ec) : 0;
+   if(ec) size = 0;
+
+   // a file with a different record layout starts over
+   bool fresh = (size < sizeof(LogFileHeader) || (size - sizeof(LogFileHeader)) % LOG_RECORD_SIZE != 0);
+   if(fresh == false) {
+      LogFileHeader header{};
+      ifstream in(_path, ios::binary);
+      in.read(reinterpret_cast<char *>(&header), sizeof(header));
+      fresh = (in.good() == false || memcmp(header.magic, LOG_FILE_MAGIC, sizeof(header.magic)) != 0 ||
+               header.recordSize != LOG_RECORD_SIZE);
+   } // end if
+
+   _file.open(_path, ios::binary | (fresh == true ? ios::trunc : ios::app));
+   if(_file.is_open() == false) {
+      _errorStr = "can not open log file " + _path + ": " + strerror(errno);
+      return -1;
+   } // end if
+
+   if(fresh == true) {
+      LogFileHeader header{};
+      memcpy(header.magic, LOG_FILE_MAGIC, sizeof(header.magic));
+      header.recordSize = LOG_RECORD_SIZE;
+      header.eventCount = static_cast<uint32_t>(LogEvent::Count);
+      _file.write(reinterpret_cast<const char *>(&header), sizeof(header));
+      size = sizeof(header);
+   } // end if
+
+   _fileBytes = size;
+   return 0;
+} // end OpenFile
+
+
+// path.(files - 2) -> path.(files - 1) ... path -> path.1, then a new path
+int Logger::Rotate() {
+   error_code ec;
+
+   _file.close();
+
+   for(unsigned i = _files - 1; i > 0; --i) {
+      string from = (i == 1 ? _path : _path + "." + to_string(i - 1));
+      string to = _path + "." + to_string(i);
+      if(filesystem::exists(from, ec) == true) filesystem::rename(from, to, ec);
+   } // end for
+
+   // one file only, start it over
+   if(_files == 1) filesystem::remove(_path, ec);
+
+   return OpenFile();
+} // end Rotate
+
+
+uint64_t Logger::NowNs() {
+   timespec ts;
+   clock_gettime(CLOCK_REALTIME, &ts);
+   return static_cast<uint64_t>(ts.tv_sec) * 1000000000ull + static_cast<uint64_t>(ts.tv_nsec);
+} // end NowNs
+
+
+LogLevel LogLevelFromString(const string &level) {
+   if(level == "debug") return LogLevel::Debug;
+   if(level == "warn") return LogLevel::Warn;
+   if(level == "error") return LogLevel::Error;
+   return LogLevel::Info;
+} // end LogLevelFromString
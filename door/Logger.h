@@ -0,0 +1,219 @@
+/// file: Logger.h header for Logger class
+/// author: Bennett Cook
+/// date: 10-17-2026
+/// description: asynchronous binary logger. Log() copies the event id and
+/// the raw arguments into a 64 byte record (LogEvents.h) and pushes it on
+/// a lock free ring owned by the calling thread, no formatting and no
+/// allocation on the caller. A background thread drains the rings every
+/// LOG_FLUSH_MS, writes the records to the log file and rotates the file
+/// at a size limit. When printing is enabled (PrintUtils.h) the writer
+/// also formats the records to the console. Decode a log file with the
+/// logdecode tool.
+/// usage: Log(LogLevel::Info, LogEvent::MotorSpeed, hz);
+
+
+// header guard
+#ifndef LOGGER_H
+#define LOGGER_H
+
+#include <cstdint>
+#include <cstring>
+#include <ctime>
+#include <string>
+#include <string_view>
+#include <vector>
+#include <array>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <fstream>
+#include <type_traits>
+#include <boost/atomic.hpp>
+#include <boost/core/noncopyable.hpp>
+
+#include "LogEvents.h"
+
+using namespace std;
+
+
+// records per thread ring, a power of 2
+const size_t LOG_RING_SIZE = 1024;
+
+// how often the writer thread drains the rings
+const unsigned LOG_FLUSH_MS = 100;
+
+
+class Logger : private boost::noncopyable {
+public:
+
+   // the one logger, logging is off until Open()
+   static Logger &Instance();
+
+   ~Logger();
+
+   // start the writer thread, path is rotated to path.1 ... path.(files - 1)
+   // when it would pass maxBytes
+   int Open(const string &path, size_t maxBytes, unsigned files, LogLevel level);
+
+   // write what is in the rings and stop the writer thread
+   void Close();
+
+   bool IsEnabled(LogLevel level) {
+      return _enabled.load(boost::memory_order_relaxed) == true &&
+             level >= _level.load(boost::memory_order_relaxed);
+   } // end IsEnabled
+
+   template <typename... Types>
+   void Log(LogLevel level, LogEvent event, const Types &... args) {
+      if(IsEnabled(level) == false) return;
+
+      LogRecord record{};
+      record.timestampNs = NowNs();
+      record.event = static_cast<uint16_t>(event);
+      record.level = static_cast<uint8_t>(level);
+
+      size_t slot = 0;
+      (AddArg(record, slot, args), ...);
+
+      ThreadRing()->Push(record);
+   } // end Log
+
+   // records lost because a ring was full
+   uint64_t GetDropped();
+
+   string GetErrorStr() { return _errorStr; }
+
+private:
+
+   Logger();
+
+   // single producer (the owner thread), single consumer (the writer)
+   class Ring {
+   public:
+      Ring() : _head(0), _tail(0), _dropped(0) {}
+
+      void Push(const LogRecord &record) {
+         size_t head = _head.load(boost::memory_order_relaxed);
+         if(head - _tail.load(boost::memory_order_acquire) == LOG_RING_SIZE) {
+            _dropped.fetch_add(1, boost::memory_order_relaxed);
+            return;
+         } // end if
+
+         _records[head & (LOG_RING_SIZE - 1)] = record;
+         _head.store(head + 1, boost::memory_order_release);
+      } // end Push
+
+      bool Pop(LogRecord &record) {
+         size_t tail = _tail.load(boost::memory_order_relaxed);
+         if(tail == _head.load(boost::memory_order_acquire)) return false;
+
+         record = _records[tail & (LOG_RING_SIZE - 1)];
+         _tail.store(tail + 1, boost::memory_order_release);
+         return true;
+      } // end Pop
+
+      uint64_t GetDropped() { return _dropped.load(boost::memory_order_relaxed); }
+
+   private:
+      // head and tail on their own cache lines so the two threads don't share one
+      alignas(64) boost::atomic<size_t> _head;
+      alignas(64) boost::atomic<size_t> _tail;
+      alignas(64) boost::atomic<uint64_t> _dropped;
+      std::array<LogRecord, LOG_RING_SIZE> _records;
+   }; // end class
+
+   // the ring of the calling thread, made on its first Log()
+   Ring *ThreadRing() {
+      thread_local Ring *ring = nullptr;
+      if(ring == nullptr) ring = AddRing();
+      return ring;
+   } // end ThreadRing
+
+   Ring *AddRing();
+   void WriterTask();
+   size_t Drain(vector<LogRecord> &records);
+   int Write(const vector<LogRecord> &records);
+   int OpenFile();
+   int Rotate();
+
+   static uint64_t NowNs();
+
+   // integers, floating point and text, anything else does not compile
+   template <typename T>
+   static void AddArg(LogRecord &record, size_t &slot, const T &arg) {
+      if(slot >= LOG_PAYLOAD_SLOTS || record.argCount >= LOG_MAX_ARGS) return;
+
+      unsigned char *dest = record.payload + slot * 8;
+      LogArg type;
+
+      if constexpr(is_convertible_v<const T &, string_view> == true) {
+         string_view text(arg);
+         size_t room = (LOG_PAYLOAD_SLOTS - slot) * 8 - 1;
+         size_t length = text.size() < room ? text.size() : room;
+         memcpy(dest, text.data(), length);
+         dest[length] = '\0';
+         slot += (length + 8) / 8;
+         type = LogArg::Text;
+      }
+      else if constexpr(is_floating_point_v<T> == true) {
+         double value = static_cast<double>(arg);
+         memcpy(dest, &value, 8);
+         ++slot;
+         type = LogArg::Double;
+      }
+      else if constexpr(is_enum_v<T> == true) {
+         int64_t value = static_cast<int64_t>(arg);
+         memcpy(dest, &value, 8);
+         ++slot;
+         type = LogArg::Int;
+      }
+      else {
+         static_assert(is_integral_v<T> == true, "log argument must be a number or text");
+         if constexpr(is_signed_v<T> == true) {
+            int64_t value = static_cast<int64_t>(arg);
+            memcpy(dest, &value, 8);
+            type = LogArg::Int;
+         }
+         else {
+            uint64_t value = static_cast<uint64_t>(arg);
+            memcpy(dest, &value, 8);
+            type = LogArg::Uint;
+         } // end if
+         ++slot;
+      } // end if
+
+      record.argTypes[record.argCount++] = static_cast<uint8_t>(type);
+   } // end AddArg
+
+   boost::atomic<bool> _enabled;
+   boost::atomic<LogLevel> _level;
+   boost::atomic<bool> _stop;
+
+   // rings are never freed while the logger lives, a thread that exits
+   // leaves its ring to be drained
+   mutex _ringsMutex;
+   vector<unique_ptr<Ring>> _rings;
+
+   thread _writer;
+   string _path;
+   size_t _maxBytes;
+   unsigned _files;
+   ofstream _file;
+   size_t _fileBytes;
+   uint64_t _droppedReported;
+   string _errorStr;
+
+}; // end class
+
+
+// log through the one Logger
+template <typename... Types>
+inline void Log(LogLevel level, LogEvent event, const Types &... args) {
+   Logger::Instance().Log(level, event, args...);
+} // end Log
+
+// level from the configuration file string, debug, info, warn or error
+LogLevel LogLevelFromString(const string &level);
+
+
+#endif // end header guard
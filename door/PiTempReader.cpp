@@ -7,7 +7,8 @@ PiTempReader::PiTempReader() {
 } // end ctor 
 
 PiTempReader::~PiTempReader() {
-
+   // RunTask() may be running on the reader pool
+   CancelRead();
 } // end dtor 
 
 int PiTempReader::RunTask() {
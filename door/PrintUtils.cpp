@@ -1,6 +1,8 @@
 
 #include "PrintUtils.h"
 #include <boost/assert.hpp> 
+#include <mutex>
+#include <memory>
 
 void vtprint(){
    cout << endl;
@@ -74,6 +76,19 @@ bool WatchConsole::CheckForInput() {
 } // end CheckForInput
 
 
+bool WatchConsole::ReadLine() {
+   string input;
+
+   getline(cin, input);
+   _input = input;
+
+   // eof, stdin closed or redirected from /dev/null
+   if(cin.eof() == true) cin.clear();
+
+   return input.size() > 0;
+} // end ReadLine
+
+
 void WatchConsole::Close() { 
    _quit = true;          // will stop the async() 
 
@@ -116,48 +131,101 @@ int WatchConsole::GetUserInput() {
 } // end GetUserInput
 
 
-SmallIpc::SmallIpc() {
+// set by SmallIpc or the first PrintEnableFlag() call, read on every print
+static std::atomic<std::atomic<int> *> printEnableFlag{nullptr};
+
+// the mapping for PrintEnableFlag() when SmallIpc is not in this process,
+// printEnableChecked is set after the one lookup so a miss is not retried
+static mutex printEnableMutex;
+static unique_ptr<managed_shared_memory> printEnableSegment;
+static std::atomic<bool> printEnableChecked{false};
+
+
+// remove an old segment and make the flag, std::atomic<int> is lock 
+// free so it works across processes
+static managed_shared_memory CreatePrintSegment() {
    shared_memory_object::remove( SharedMemoryName.c_str() );
-   managed_shared_memory object{ open_or_create, SharedMemoryName.c_str(), 1024 };
-   object.construct<int>(SharedMemoryItem.c_str())(1);
+   return managed_shared_memory{ open_or_create, SharedMemoryName.c_str(), 1024 };
+} // end CreatePrintSegment
+
+
+SmallIpc::SmallIpc() : _segment{CreatePrintSegment()} {
+   std::atomic<int> *flag = _segment.construct<std::atomic<int>>(SharedMemoryItem.c_str())(1);
+   printEnableFlag.store(flag, std::memory_order_release);
 } // end ctor 
 
 
 SmallIpc::~SmallIpc() {
+   printEnableChecked.store(true, std::memory_order_release);
+   printEnableFlag.store(nullptr, std::memory_order_release);
    shared_memory_object::remove( SharedMemoryName.c_str() );
 } // end dtor
 
 
 int SmallIpc::Writer(int val) {
-   managed_shared_memory object{ open_only, SharedMemoryName.c_str() };
-   pair<int *, size_t> p = object.find<int>(SharedMemoryItem.c_str());
+   std::atomic<int> *flag = printEnableFlag.load(std::memory_order_acquire);
 
-   if(p.first) {
-      *p.first = val;
+   if(flag) {
+      flag->store(val, std::memory_order_relaxed);
    } // end if 
 
    return 0;
 } // Writer 
 
 
-int IpcReader() {
-   int ret = 0;
+std::atomic<int> *PrintEnableFlag() {
+   std::atomic<int> *flag = printEnableFlag.load(std::memory_order_acquire);
+   if(flag) return flag;
 
-   managed_shared_memory object{ open_only, SharedMemoryName.c_str() };
-   std::pair<int *, std::size_t> p = object.find<int>(SharedMemoryItem.c_str());
+   // already looked and found nothing, printing stays off until
+   // ResetPrintEnableFlag()
+   if(printEnableChecked.load(std::memory_order_acquire)) return nullptr;
 
-   if(p.first) {
-      ret = *p.first;
-   } // end if 
+   // no SmallIpc here, map the segment made by another process once
+   lock_guard<mutex> lock(printEnableMutex);
+   if(printEnableChecked.load(std::memory_order_relaxed)) {
+      return printEnableFlag.load(std::memory_order_acquire);
+   } // end if
 
-   return ret;
+   try {
+      auto segment = make_unique<managed_shared_memory>(open_only, SharedMemoryName.c_str());
+      flag = segment->find<std::atomic<int>>(SharedMemoryItem.c_str()).first;
+      if(flag != nullptr) {
+         printEnableSegment = std::move(segment);
+         printEnableFlag.store(flag, std::memory_order_release);
+      } // end if
+   }
+   catch(const interprocess_exception &) {
+      // no segment yet, printing stays off
+      flag = nullptr;
+   } // end try
+
+   printEnableChecked.store(true, std::memory_order_release);
+   return flag;
+} // end PrintEnableFlag
+
+
+void ResetPrintEnableFlag() {
+   lock_guard<mutex> lock(printEnableMutex);
+
+   // drop only a mapping made here, a SmallIpc flag stays published
+   if(printEnableSegment) {
+      printEnableFlag.store(nullptr, std::memory_order_release);
+      printEnableSegment.reset();
+   } // end if
+
+   printEnableChecked.store(false, std::memory_order_release);
+} // end ResetPrintEnableFlag
+
+
+int IpcReader() {
+   std::atomic<int> *flag = PrintEnableFlag();
+   return flag != nullptr ? flag->load(std::memory_order_relaxed) : 0;
 } // end IpcReader
 
 
-void PrintLn(string line) {
-   int enable = IpcReader();
-   if(enable == 1) {
+void PrintLn(const string &line) {
+   if(PrintEnabled() == true) {
       cout << line << endl;
    } // end if 
 } // end PrintLn
-
@@ -55,6 +55,10 @@ public:
    int Setup();
    bool CheckForInput();
 
+   // read a line now, for use when stdin is known to be readable
+   // (an event loop watching STDIN_FILENO), no async thread needed
+   bool ReadLine();
+
    string GetInput() { return _input; }
    string GetErrorStr() { return _errorStr; }
 
@@ -86,9 +90,11 @@ private:
 // the shared memory and then there is a PrintLn() that uses 
 // IpcReader() to enable/disable printing. PrintLn() accepts a string 
 // to print when the shared memory value is 1 and disables otherwise.
-// usage: PrintLn((boost::format{ "loop count %1%" } % i).str());.
-// you can use PrintLn() with just a string or boost::format, as shown,
-// for more flexible, inline style simplicity
+// usage: PrintLn("loop count %1%", i);.
+// you can use PrintLn() with just a string or a boost::format string 
+// and its arguments, as shown, for more flexible, inline style simplicity
+// The shared memory is mapped once, SmallIpc publishes the address of
+// the flag and PrintLn() only does a relaxed load of it.
 class SmallIpc : private boost::noncopyable {
 public:
 
@@ -98,17 +104,43 @@ public:
    int Writer(int val);
 
 private:
+   managed_shared_memory _segment;
 }; // end SmallIpc
 
+// the print enable flag, nullptr if the shared memory doesn't exist.
+// maps the segment on the first call when SmallIpc is not in this process,
+// a miss is remembered and not looked up again
+std::atomic<int> *PrintEnableFlag();
+
+// forget the lookup so the next PrintEnableFlag() maps the segment again,
+// call it with no prints running, e.g. after the other process restarts
+void ResetPrintEnableFlag();
+
 // read the shared memory item
 // at this time, IpcReader() iss not intended for use outside of PrintLn()
 // but it could be used in future applications for more than print enabling
 int IpcReader();
 
+inline bool PrintEnabled() {
+   std::atomic<int> *flag = PrintEnableFlag();
+   return flag != nullptr && flag->load(std::memory_order_relaxed) == 1;
+} // end PrintEnabled
+
 // print a line if the shared memory item value is 1
-// usage: PrintLn((boost::format{ "loop count %1%" } % i).str());
 // usage: PrintLn("print something");
-void PrintLn(string line);
+void PrintLn(const string &line);
+
+// format and print only if the shared memory item value is 1, so a
+// disabled print costs one load and no formatting
+// usage: PrintLn("loop count %1%", i);
+template <typename T, typename... Types>
+void PrintLn(const char *fmt, const T &first, const Types &... rest) {
+   if(PrintEnabled() == false) return;
+
+   boost::format f{fmt};
+   ((f % first) % ... % rest);
+   cout << f.str() << endl;
+} // end PrintLn
 //*******************************************************************
 
 
@@ -73,11 +73,30 @@ int ReadConfigurationFile::ReadIn() {
       _appConfig.sunriseOffsetMin = GetScalarData<int>(tree, CONFIG_SUNRISE_OFFSET_MINUTES);
       _appConfig.sunsetOffsetMin = GetScalarData<int>(tree, CONFIG_SUNSET_OFFSET_MINUTES);
 
-      _appConfig.houseNumber = GetScalarData<string>(tree, CONFIG_ADDRESS_HOUSE_NUMBER);
-      _appConfig.street = GetScalarData<string>(tree, CONFIG_ADDRESS_STREET);
-      _appConfig.city = GetScalarData<string>(tree, CONFIG_ADDRESS_CITY);
-      _appConfig.state = GetScalarData<string>(tree, CONFIG_ADDRESS_STATE);
-      _appConfig.zipCode = GetScalarData<string>(tree, CONFIG_ADDRESS_ZIP_CODE);
+      _appConfig.latitude = GetScalarData<double>(tree, CONFIG_LATITUDE);
+      _appConfig.longitude = GetScalarData<double>(tree, CONFIG_LONGITUDE);
+
+      _appConfig.dbQueueSize = GetOptionalScalarData<int>(tree, CONFIG_DB_QUEUE_SIZE, DEFAULT_DB_QUEUE_SIZE);
+      _appConfig.dbBatchRows = GetOptionalScalarData<int>(tree, CONFIG_DB_BATCH_ROWS, DEFAULT_DB_BATCH_ROWS);
+      _appConfig.dbBatchMS = GetOptionalScalarData<int>(tree, CONFIG_DB_BATCH_MS, DEFAULT_DB_BATCH_MS);
+      _appConfig.dbSynchronous = GetOptionalScalarData<string>(tree, CONFIG_DB_SYNCHRONOUS, DEFAULT_DB_SYNCHRONOUS);
+      _appConfig.dbRawRetentionDays = GetOptionalScalarData<int>(tree, CONFIG_DB_RAW_RETENTION_DAYS, DEFAULT_DB_RAW_RETENTION_DAYS);
+      _appConfig.db5MinRetentionDays = GetOptionalScalarData<int>(tree, CONFIG_DB_5MIN_RETENTION_DAYS, DEFAULT_DB_5MIN_RETENTION_DAYS);
+      _appConfig.dbRollupIntervalSec = GetOptionalScalarData<int>(tree, CONFIG_DB_ROLLUP_INTERVAL_SEC, DEFAULT_DB_ROLLUP_INTERVAL_SEC);
+      _appConfig.eventLoop = GetOptionalScalarData<bool>(tree, CONFIG_EVENT_LOOP, DEFAULT_EVENT_LOOP);
+      _appConfig.idleTickMS = GetOptionalScalarData<int>(tree, CONFIG_IDLE_TICK_MS, DEFAULT_IDLE_TICK_MS);
+      _appConfig.gpioEdgeEvents = GetOptionalScalarData<bool>(tree, CONFIG_GPIO_EDGE_EVENTS, DEFAULT_GPIO_EDGE_EVENTS);
+      _appConfig.gpioDebounceUs = GetOptionalScalarData<int>(tree, CONFIG_GPIO_DEBOUNCE_US, DEFAULT_GPIO_DEBOUNCE_US);
+      _appConfig.logPath = GetOptionalScalarData<string>(tree, CONFIG_LOG_PATH, DEFAULT_LOG_PATH);
+      _appConfig.logMaxBytes = GetOptionalScalarData<int>(tree, CONFIG_LOG_MAX_BYTES, DEFAULT_LOG_MAX_BYTES);
+      _appConfig.logFiles = GetOptionalScalarData<int>(tree, CONFIG_LOG_FILES, DEFAULT_LOG_FILES);
+      _appConfig.logLevel = GetOptionalScalarData<string>(tree, CONFIG_LOG_LEVEL, DEFAULT_LOG_LEVEL);
+      _appConfig.httpPort = GetOptionalScalarData<int>(tree, CONFIG_HTTP_PORT, DEFAULT_HTTP_PORT);
+      _appConfig.httpAddress = GetOptionalScalarData<string>(tree, CONFIG_HTTP_ADDRESS, DEFAULT_HTTP_ADDRESS);
+      _appConfig.sunTablePath = GetOptionalScalarData<string>(tree, CONFIG_SUN_TABLE_PATH, DEFAULT_SUN_TABLE_PATH);
+      _appConfig.lightReadIntervalSec = GetOptionalScalarData<int>(tree, CONFIG_LIGHT_READ_INTERVAL_SEC, DEFAULT_LIGHT_READ_INTERVAL_SEC);
+      _appConfig.si7021HoldMode = GetOptionalScalarData<bool>(tree, CONFIG_SI7021_HOLD_MODE, DEFAULT_SI7021_HOLD_MODE);
+      _appConfig.si7021CheckCrc = GetOptionalScalarData<bool>(tree, CONFIG_SI7021_CHECK_CRC, DEFAULT_SI7021_CHECK_CRC);
 
    }
    catch(std::exception &e) {
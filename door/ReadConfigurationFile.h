@@ -151,6 +151,30 @@ private:
       return ret;
    } // end GetScalarData
 
+   /// \brief template function to read an optional scalar from the property tree,
+   /// returns defaultValue if child_label is not in the file 
+   template<typename T>
+   T GetOptionalScalarData(const pt::ptree &tree, const string &child_label, T defaultValue) {
+      T ret = defaultValue;
+      _errorStr = "";
+
+      try {
+         boost::optional<T> tmp = tree.get_optional<T>(child_label);
+         if(tmp.is_initialized()) {
+            ret = tmp.get();
+         } // end if 
+      }
+      catch(std::exception &e) {
+         _errorStr = "error on child read ";
+         _errorStr += e.what();
+      } // end try/catch
+
+      // if exception occurred throw  
+      if(_errorStr.length() > 0) throw _errorStr.c_str();
+
+      return ret;
+   } // end GetOptionalScalarData
+
 }; // end class 
 
 #endif  // end header guard
@@ -3,36 +3,47 @@
 
 Reader::Reader() {
    _status = ReaderStatus::NotStarted;
-   _stopWait = false;
-   _restart = false;
+   _sec = 0;
 } // end ctor 
 
 Reader::~Reader() {
+   CancelRead();
 } // end dtor 
 
 
+// the error string is written first, the atomic status store 
+// publishes it and the reader data to the main thread
 void Reader::SetStatus(ReaderStatus status, string errorStr) {
-   _status = status;
    _errorStr = errorStr;
+   _status = status;
 } // end SetStatus
 
 
 void Reader::SetError(const string &errorStr) {
-   _status = ReaderStatus::NotStarted; 
    _errorStr = errorStr; 
+   _status = ReaderStatus::NotStarted; 
 } // end SetError
 
 
-// ref: https://www.cplusplus.com/reference/thread/thread/detach/
 /// \ret return 0 wait started 
-/// \ret return -1 can not start while in waiting
+/// \ret return 1 can not start while in waiting
 int Reader::ReadAfterSec(unsigned sec) {
    int ret = 0;
 
    // allow another run to start is NotStarted
    if(ReaderStatus::Waiting != _status) {
+      auto now = ReaderPool::Clock::now();
+      auto period = chrono::seconds(sec);
+
+      // keep the cadence of the last read unless it is more than a period old
+      if(_due <= now && _due + period > now) 
+         _due += period;
+      else
+         _due = now + period;
+
+      _sec = sec;
       _status = ReaderStatus::Waiting;
-      thread([this](unsigned s) {this->WaitThenRun(s); }, sec).detach();
+      ReaderPool::Instance().Submit(this, _due);
    }
    else {
       ret = 1; // in process
@@ -42,33 +53,39 @@ int Reader::ReadAfterSec(unsigned sec) {
 } // end ReadAfterSec
 
 
-void Reader::WaitThenRun(unsigned sec) {
-   unsigned countDown = sec;
+// a read already running is not stopped, it completes as usual
+void Reader::StopWaiting() {
+   if(ReaderStatus::Waiting != _status) return;
 
-   // count down for 1 second then run RunTask()
-   // if sec = 0 the while loop will not run but after countDown will be max unsigned
-   while(countDown--) {
+   if(ReaderPool::Instance().Cancel(this, false) == true) 
+      _status = ReaderStatus::NotStarted;
 
-      // allow client to trigger a countdown rest34art 
-      if(_restart == true) {
-         _restart = false;
-         countDown = sec;
-      } // end if 
+} // end StopWaiting
 
-      // _stopWait is set from StopWaiting() is true set to false and return 
-      // without running RunTask()
-      if(_stopWait == true) {
-         _stopWait = false;
 
-         _status = ReaderStatus::NotStarted;
-         return;
-      } // end if 
+// start the wait over from now
+void Reader::RestartWait() {
+   if(ReaderStatus::Waiting != _status) return;
 
-      this_thread::sleep_for(chrono::seconds(1));
-   } // end while
-   
-   RunTask();
-} // end WaitThenRun
+   auto due = ReaderPool::Clock::now() + chrono::seconds(_sec);
+   if(ReaderPool::Instance().Reschedule(this, due) == true) 
+      _due = due;
 
+} // end RestartWait
 
 
+void Reader::CancelRead() {
+
+   // a reader that never read doesn't need to start the pool
+   if(_due == ReaderPool::Clock::time_point{}) return;
+
+   ReaderPool::Instance().Cancel(this, true);
+} // end CancelRead
+
+
+void Reader::RunJob() {
+   
+   RunTask();
+
+   if(_notify) _notify();
+} // end RunJob
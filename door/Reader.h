@@ -6,10 +6,12 @@
 #include <string>
 #include <iostream>
 #include <iomanip>
-#include <thread>
 #include <chrono>
+#include <functional>
 #include <boost/atomic.hpp>
 
+#include "ReaderPool.h"
+
 using namespace std;
 
 
@@ -27,26 +29,45 @@ public:
    Reader();
    virtual ~Reader();
 
+   // read the error after GetStatus() returned Error, the status store
+   // is the hand off from the pool thread
    string GetError() { return _errorStr; }
    ReaderStatus GetStatus(){return _status;}
-   void ResetStatus() {_status = ReaderStatus::NotStarted; _errorStr.clear(); }
+   void ResetStatus() {_errorStr.clear(); _status = ReaderStatus::NotStarted; }
 
    virtual int RunTask() = 0;
+
+   // queue RunTask() on the ReaderPool sec seconds from now. When the last
+   // read was due less than sec ago the new one is due sec after it, so
+   // the read cadence doesn't drift with the main loop
    int ReadAfterSec(unsigned sec);
-   void StopWaiting() { if(ReaderStatus::Waiting == _status) _stopWait = true; }
-   void RestartWait() { if(ReaderStatus::Waiting == _status) _restart = true; }
+   void StopWaiting();
+   void RestartWait();
+
+   // drop a queued read and wait for a running one, derived class dtors
+   // call this first so RunTask() never runs on a destroyed object
+   void CancelRead();
+
+   // called on the pool thread after RunTask() finishes, used to wake
+   // the main loop so the result is handled right away. Set before ReadAfterSec()
+   void SetNotify(std::function<void()> notify) { _notify = notify; }
 
 protected:
-   void WaitThenRun(unsigned sec);
    void SetStatus(ReaderStatus status, string errorStr);
    void SetError(const string &errorStr);
    
    string _errorStr;
-   ReaderStatus _status;
+   boost::atomic<ReaderStatus> _status;
 
 private:
-   boost::atomic<bool> _stopWait;
-   boost::atomic<bool> _restart;
+   friend class ReaderPool;
+
+   // run by the ReaderPool worker when the deadline passes
+   void RunJob();
+
+   unsigned _sec;
+   ReaderPool::Clock::time_point _due;
+   std::function<void()> _notify;
 
 }; // end class 
 
@@ -0,0 +1,139 @@
+#include "ReaderPool.h"
+#include "Reader.h"
+#include <algorithm>
+
+
+ReaderPool &ReaderPool::Instance() {
+   static ReaderPool pool;
+   return pool;
+} // end Instance
+
+
+ReaderPool::ReaderPool() {
+   _stop = false;
+
+   for(unsigned i = 0; i < READER_POOL_THREADS; ++i) {
+      _workers.emplace_back([this]() { this->WorkerTask(); });
+   } // end for
+
+} // end ctor
+
+
+ReaderPool::~ReaderPool() {
+
+   {
+      lock_guard<mutex> lock(_mutex);
+      _stop = true;
+      _heap.clear();
+   }
+
+   _jobCv.notify_all();
+
+   for(auto &worker : _workers) {
+      if(worker.joinable() == true) worker.join();
+   } // end for
+
+} // end dtor
+
+
+void ReaderPool::Submit(Reader *reader, Clock::time_point due) {
+
+   {
+      lock_guard<mutex> lock(_mutex);
+      RemoveJob(reader);
+      _heap.push_back(Job{due, reader});
+      push_heap(_heap.begin(), _heap.end(), LaterJob);
+   }
+
+   // the new job may be earlier than the one the workers wait for
+   _jobCv.notify_all();
+
+} // end Submit
+
+
+bool ReaderPool::Reschedule(Reader *reader, Clock::time_point due) {
+
+   {
+      lock_guard<mutex> lock(_mutex);
+
+      auto it = find_if(_heap.begin(), _heap.end(), [reader](const Job &j) { return j.reader == reader; });
+      if(it == _heap.end()) return false;
+
+      it->due = due;
+      make_heap(_heap.begin(), _heap.end(), LaterJob);
+   }
+
+   _jobCv.notify_all();
+   return true;
+} // end Reschedule
+
+
+bool ReaderPool::Cancel(Reader *reader, bool wait) {
+   unique_lock<mutex> lock(_mutex);
+
+   bool removed = RemoveJob(reader);
+
+   if(wait == true) {
+      _doneCv.wait(lock, [this, reader]() { return IsRunning(reader) == false; });
+   } // end if
+
+   return removed;
+} // end Cancel
+
+
+void ReaderPool::WorkerTask() {
+   unique_lock<mutex> lock(_mutex);
+
+   while(_stop == false) {
+
+      if(_heap.empty() == true) {
+         _jobCv.wait(lock);
+         continue;
+      } // end if
+
+      // sleep to the earliest deadline, a Submit() or Cancel() wakes the
+      // worker to look at the heap again
+      if(Clock::now() < _heap.front().due) {
+         _jobCv.wait_until(lock, _heap.front().due);
+         continue;
+      } // end if
+
+      Job job = _heap.front();
+      pop_heap(_heap.begin(), _heap.end(), LaterJob);
+      _heap.pop_back();
+      _running.push_back(job.reader);
+
+      lock.unlock();
+      job.reader->RunJob();
+      lock.lock();
+
+      _running.erase(find(_running.begin(), _running.end(), job.reader));
+      _doneCv.notify_all();
+
+   } // end while
+
+} // end WorkerTask
+
+
+// with the mutex held
+bool ReaderPool::RemoveJob(Reader *reader) {
+
+   auto it = remove_if(_heap.begin(), _heap.end(), [reader](const Job &j) { return j.reader == reader; });
+   if(it == _heap.end()) return false;
+
+   _heap.erase(it, _heap.end());
+   make_heap(_heap.begin(), _heap.end(), LaterJob);
+   return true;
+} // end RemoveJob
+
+
+// with the mutex held
+bool ReaderPool::IsRunning(Reader *reader) {
+   return find(_running.begin(), _running.end(), reader) != _running.end();
+} // end IsRunning
+
+
+// min-heap on the deadline for the std heap functions
+bool ReaderPool::LaterJob(const Job &a, const Job &b) {
+   return a.due > b.due;
+} // end LaterJob
@@ -0,0 +1,77 @@
+/// file: ReaderPool.h header for ReaderPool class
+/// author: Bennett Cook
+/// date: 10-17-2026
+/// description: a small fixed set of worker threads shared by all the
+/// Reader classes. Reader::ReadAfterSec() submits a job with a deadline,
+/// the jobs wait in a deadline ordered heap and the first free worker
+/// runs RunTask() when the deadline passes. No thread is created per read.
+
+
+// header guard
+#ifndef READERPOOL_H
+#define READERPOOL_H
+
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <chrono>
+#include <boost/core/noncopyable.hpp>
+
+using namespace std;
+
+class Reader;
+
+// the sensor reads are short i2c transfers, a light read that changes its
+// range waits on integrations, two workers keep one slow read from holding the others
+const unsigned READER_POOL_THREADS = 2;
+
+
+class ReaderPool : private boost::noncopyable {
+public:
+
+   using Clock = std::chrono::steady_clock;
+
+   // the one pool, the workers start on the first call
+   static ReaderPool &Instance();
+
+   ~ReaderPool();
+
+   // run reader->RunTask() at due, replaces a job already queued for the reader
+   void Submit(Reader *reader, Clock::time_point due);
+
+   // move the queued job of the reader to due, false if none is queued
+   bool Reschedule(Reader *reader, Clock::time_point due);
+
+   // drop the queued job of the reader, if wait is true also wait
+   // for a RunTask() that is running now to return.
+   // return true if a queued job was dropped
+   bool Cancel(Reader *reader, bool wait);
+
+private:
+
+   ReaderPool();
+
+   // heap entry, at most one per reader
+   struct Job {
+      Clock::time_point due;
+      Reader *reader;
+   }; // end struct
+
+   vector<thread> _workers;
+   vector<Job> _heap;
+   vector<Reader *> _running;
+   mutex _mutex;
+   condition_variable _jobCv;
+   condition_variable _doneCv;
+   bool _stop;
+
+   void WorkerTask();
+   bool RemoveJob(Reader *reader);
+   bool IsRunning(Reader *reader);
+   static bool LaterJob(const Job &a, const Job &b);
+
+}; // end class
+
+
+#endif // end header guard
@@ -1,5 +1,9 @@
-
 #include "Rp4bPwm.h"
+#include <fcntl.h>
+#include <unistd.h>
+#include <cerrno>
+#include <cstring>
+#include <cstdio>
 
 
 Rp4bPwm::Rp4bPwm(PwmNumber pwmNum){
@@ -8,6 +12,10 @@ Rp4bPwm::Rp4bPwm(PwmNumber pwmNum){
    _enabled = false;
    _period = 0;
    _dutyCycle = 0;
+   _dutyPercent = 0;
+   _periodFd = -1;
+   _dutyCycleFd = -1;
+   _enableFd = -1;
 
    _exportFilePath = "/sys/class/pwm/pwmchip0/export";
    _unexportFilePath = "/sys/class/pwm/pwmchip0/unexport";
@@ -24,8 +32,10 @@ Rp4bPwm::Rp4bPwm(PwmNumber pwmNum){
 Rp4bPwm::~Rp4bPwm(){
 
    // use RAII pattern
-   Enable(false);
-   Reserve(false);
+   if(_reserved == true) {
+      Enable(false);
+      Reserve(false);
+   } // end if
 
 } // end dtor 
 
@@ -50,34 +60,73 @@ int Rp4bPwm::SetPwmNumInPath(string &path){
 } // end SetPwmNumInPath
 
 
-int Rp4bPwm::WriteFile(const string &path, const string &value){
-      int ret = 0;
+// export and unexport, the only files not kept open
+int Rp4bPwm::WriteFile(const string &path, unsigned value){
 
-      fstream file;
-      file.open(path, ios::out);
-      if(!file) {
-         ret = -1;
-         _errStr = "file open failed";
-      }
-      else {
+   int fd = open(path.c_str(), O_WRONLY | O_CLOEXEC);
+   if(fd < 0) {
+      _errStr = "open " + path + " failed: " + strerror(errno);
+      return -1;
+   } // end if
          
-         file << value;
-         if(file.fail()){
-            ret = -1;
-            _errStr = "file write failed";
-         } // end fi 
+   int ret = WriteFd(fd, value, path.c_str());
+   close(fd);
 
-         file.close(); 
-      } // end if 
+   return ret;
+} // end WriteFile
+
+
+// a sysfs attribute is written whole at offset 0, no seek or reopen
+int Rp4bPwm::WriteFd(int fd, unsigned value, const char *what){
+
+   char text[16];
+   int length = snprintf(text, sizeof(text), "%u", value);
+
+   if(pwrite(fd, text, static_cast<size_t>(length), 0) != length) {
+      _errStr = string("pwm write ") + what + " failed: " + strerror(errno);
+      return -1;
+   } // end if
+
+   return 0;
+} // end WriteFd
+
+
+int Rp4bPwm::OpenFiles(){
+
+   const string *paths[3] = {&_periodFilePath, &_dutyCycleFilePath, &_enableFilePath};
+   int *fds[3] = {&_periodFd, &_dutyCycleFd, &_enableFd};
+
+   for(int i = 0; i < 3; ++i) {
+
+      for(int tries = 0; *fds[i] < 0; ++tries) {
+         *fds[i] = open(paths[i]->c_str(), O_WRONLY | O_CLOEXEC);
+         if(*fds[i] >= 0) break;
 
-      this_thread::sleep_for(chrono::milliseconds(100));
+         if(tries == PWM_OPEN_TRIES || (errno != ENOENT && errno != EACCES)) {
+            _errStr = "open " + *paths[i] + " failed: " + strerror(errno);
+            CloseFiles();
+            return -1;
+         } // end if
 
-      return ret;
-   } // end WriteFile
+         this_thread::sleep_for(chrono::milliseconds(PWM_OPEN_WAIT_MS));
+      } // end for
+   } // end for
+
+   return 0;
+} // end OpenFiles
+
+
+void Rp4bPwm::CloseFiles(){
+
+   for(int *fd : {&_periodFd, &_dutyCycleFd, &_enableFd}) {
+      if(*fd >= 0) close(*fd);
+      *fd = -1;
+   } // end for
+
+} // end CloseFiles
 
 
 int Rp4bPwm::Reserve(bool state){
-   int ret = 0;
    int result = 0;
    
    if(state == true){
@@ -92,7 +141,18 @@ int Rp4bPwm::Reserve(bool state){
       SetPwmNumInPath(_dutyCycleFilePath);
       SetPwmNumInPath(_enableFilePath);
 
-      result = WriteFile(_exportFilePath, lexical_cast<string>(static_cast<int>(_pwmNum)));
+      // EBUSY is a pwm left exported by an earlier run, use it
+      result = WriteFile(_exportFilePath, static_cast<unsigned>(_pwmNum));
+      if(result != 0 && errno != EBUSY) return -1;
+
+      if(OpenFiles() != 0) return -1;
+
+      // a known state, off with a duty cycle that fits any period
+      if(WriteFd(_enableFd, 0, "enable") != 0 || WriteFd(_dutyCycleFd, 0, "duty_cycle") != 0) {
+         CloseFiles();
+         return -1;
+      } // end if
+
       _reserved = true;
    }
    else {
@@ -100,89 +160,86 @@ int Rp4bPwm::Reserve(bool state){
       if(_reserved == false) {
          _errStr = "pwm resource is already released";
          return -1;
-      }
-      else {
+      } // end if
 
-         result = WriteFile(_unexportFilePath, lexical_cast<string>(static_cast<int>(_pwmNum)));
-         if(result == 0)
-            _reserved = false;
+      CloseFiles();
+      _reserved = false;
 
-      } // end if 
-   } // end if 
+      result = WriteFile(_unexportFilePath, static_cast<unsigned>(_pwmNum));
+      if(result != 0) return -1;
 
-   // for debug 
-   assert(result == 0);
+   } // end if 
 
-   return ret;
+   return 0;
 } // end Reserve
 
 
 int Rp4bPwm::Enable(bool state){
-   int ret = 0;
-   int result = 0;
 
    if(_reserved != true) {
       _errStr = "no pwm resource is reserved";
       return -1;
    } // end if 
 
-   if(state == true && _enabled == true){
-      _errStr = "pwm is already enabled";
-      return -1;
-   }
-   else if(state == false && _enabled == false){
-      _errStr = "pwm is already disabled";
-      return -1;
-   }
-   else if(state == true && _enabled == false){
-      result = WriteFile(_enableFilePath, "1");
-      _enabled = true;
-   }
-   else if(state == false && _enabled == true){
-      result = WriteFile(_enableFilePath, "0");
-      _enabled = false;
-   } // end if 
+   if(state == _enabled) return 0;
 
-   // for debug 
-   assert(result == 0);
+   if(WriteFd(_enableFd, state == true ? 1u : 0u, "enable") != 0) return -1;
 
-   return ret;
+   _enabled = state;
+   return 0;
 } // end Enable
 
+
+// the kernel rejects a duty cycle longer than the period, so a shorter
+// period takes the duty cycle first and a longer one the period first
+int Rp4bPwm::WritePeriodAndDuty(unsigned period, unsigned dutyCycle){
+
+   bool dutyFirst = period < _dutyCycle;
+
+   if(dutyFirst == true && dutyCycle != _dutyCycle) {
+      if(WriteFd(_dutyCycleFd, dutyCycle, "duty_cycle") != 0) return -1;
+      _dutyCycle = dutyCycle;
+   } // end if 
+
+   if(period != _period) {
+      if(WriteFd(_periodFd, period, "period") != 0) return -1;
+      _period = period;
+   } // end if
+
+   if(dutyFirst == false && dutyCycle != _dutyCycle) {
+      if(WriteFd(_dutyCycleFd, dutyCycle, "duty_cycle") != 0) return -1;
+      _dutyCycle = dutyCycle;
+   } // end if
+
+   return 0;
+} // end WritePeriodAndDuty
+
+
 /// param  hz [1:10000]
 int Rp4bPwm::SetFrequenceHz(unsigned hz){
-   int ret = 0;
-   int result = 0;
 
    if(_reserved != true) {
       _errStr = "no pwm resource is reserved";
       return -1;
    } // end if 
 
-   if(_enabled == true) {
-      _errStr = "disable before setting frequency";
-      return -1;
-   } // end if 
-
    // range check
    if(hz == 0 || hz > 10000){
       _errStr = "hz is out of range[1:10000]";
       return -1;
    } // end if 
 
-   _period = static_cast<unsigned>(NanoSecIn1Second * (1.0/hz));
-   result = WriteFile(_periodFilePath, lexical_cast<string>(_period));
+   unsigned period = static_cast<unsigned>(NanoSecIn1Second * (1.0/hz));
 
-   // for debug 
-   assert(result == 0);
+   // the duty cycle keeps its percent, untouched until one is set
+   unsigned dutyCycle = _dutyPercent > 0 ? static_cast<unsigned>(period * (_dutyPercent/100.0)) : _dutyCycle;
+   if(dutyCycle > period) dutyCycle = period;
 
-   return ret;
+   return WritePeriodAndDuty(period, dutyCycle);
 } // end SetFrequenceHz
 
 
 int Rp4bPwm::SetDutyCyclePercent(unsigned dc){
-   int ret = 0;
-   int result = 0;
 
    if(_reserved != true) {
       _errStr = "no pwm resource is reserved";
@@ -195,13 +252,6 @@ int Rp4bPwm::SetDutyCyclePercent(unsigned dc){
       return -1;
    } // end if 
 
-   _dutyCycle = static_cast<unsigned>(_period * (dc/100.0));
-   result = WriteFile(_dutyCycleFilePath, lexical_cast<string>(_dutyCycle));
-
-   // for debug 
-   assert(result == 0);
-
-   return ret;
+   _dutyPercent = dc;
+   return WritePeriodAndDuty(_period, static_cast<unsigned>(_period * (dc/100.0)));
 } // end SetDutyCyclePercent
-
-
@@ -2,7 +2,10 @@
 // file Rp4bPwm.h
 // author: BCook
 // date: 06/16/2021 
-// description: header file for the sql utilites 
+// description: header file for the raspberry pi 4b sysfs pwm. The period,
+// duty_cycle and enable files are opened once when the pwm is reserved
+// and written with pwrite() at offset 0, a speed change is a write or two
+// and an enable that doesn't change the state is no write at all
 
 
 // header guard
@@ -11,12 +14,9 @@
 
 #include <string>
 #include <vector>
-#include <fstream>
-#include <iomanip>
 #include <thread>
 #include <chrono>
 #include <boost/algorithm/string.hpp>
-#include <boost/lexical_cast.hpp>
 
 
 using namespace std;
@@ -30,19 +30,30 @@ enum class PwmNumber : int {
 
 const double NanoSecIn1Second = 1.0E+09;
 
+// the pwm files show up and get their permissions from udev a moment
+// after the export, retry the opens for up to PWM_OPEN_TRIES * PWM_OPEN_WAIT_MS
+const int PWM_OPEN_TRIES = 50;
+const int PWM_OPEN_WAIT_MS = 20;
+
 //  in export use 0 (pwm0) for pin 18 and 1 (pwm1) for pin 19  
 
 
 class Rp4bPwm {
 public:
 
+   // reserves (exports) the pwm, check IsReserved()
    Rp4bPwm(PwmNumber pwmNum);
    ~Rp4bPwm();
 
+   // the period and the duty cycle for the percent, written in the order
+   // that keeps the duty cycle inside the period, enabled or not
    int SetFrequenceHz(unsigned hz);
    int SetDutyCyclePercent(unsigned dc);
+
+   // 0 if the pwm is already in state
    int Enable(bool state);
 
+   bool IsReserved(){return _reserved;}
    string GetErrStr(){return _errStr;}
 
 private:
@@ -50,10 +61,15 @@ private:
    PwmNumber _pwmNum;
    bool _reserved;
    bool _enabled;
-   unsigned _period;
-   unsigned _dutyCycle;
+   unsigned _period;       // ns
+   unsigned _dutyCycle;    // ns
+   unsigned _dutyPercent;  // 0 until SetDutyCyclePercent()
    string _errStr;
 
+   int _periodFd;
+   int _dutyCycleFd;
+   int _enableFd;
+
    string _exportFilePath;
    string _unexportFilePath;
    string _polarityFilePath;
@@ -65,7 +81,11 @@ private:
 
    int Reserve(bool state);
    int SetPwmNumInPath(string &path);
-   int WriteFile(const string &path, const string &value);
+   int OpenFiles();
+   void CloseFiles();
+   int WriteFile(const string &path, unsigned value);
+   int WriteFd(int fd, unsigned value, const char *what);
+   int WritePeriodAndDuty(unsigned period, unsigned dutyCycle);
 
 }; // end class
 
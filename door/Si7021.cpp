@@ -12,6 +12,8 @@
 Si7021::Si7021() : I2C(SI7021_I2C_ADDRESS) {
    _temperature = 0.0f;
    _humidity = 0.0f;
+   _holdMode = false;
+   _checkCrc = true;
 } // end ctor 
 
 
@@ -20,51 +22,90 @@ Si7021::~Si7021(){
 
 
 int Si7021::ReadHumidity() {
-   int ret = 0;
+   unsigned short code = 0;
 
-	// send humidity measurement command
-	unsigned char config[1] = {CMD_READ_HUMIDITY_NO_HOLD};
-	write(_fd, config, 1);
-   this_thread::sleep_for(chrono::milliseconds(WAIT_READ_MS));
+   if(ReadMeasurement(CMD_READ_HUMIDITY_HOLD, CMD_READ_HUMIDITY_NO_HOLD, code, "humidity read error") != 0) 
+      return -1;
 
-	// read 2 bytes of humidity data, humidity msb, humidity lsb
-	char data[2] = {0};
-	if(read(_fd, data, 2) != 2) {
-      ret = -1;
-      _error = "humidity read error";
-	}
-	else {
-		// convert the data
-      int combined = ((static_cast<int>(data[0]) << 8) + data[1]);
-		_humidity = ((combined * 125.0) / 65536.0) - 6;
-	} // end if
+   // the sensor can read a little past 0 to 100 
+   _humidity = ((code * 125.0) / 65536.0) - 6;
+   if(_humidity < 0.0f) _humidity = 0.0f;
+   if(_humidity > 100.0f) _humidity = 100.0f;
 
-   return ret;
+   return 0;
 } // end readHumidity
 
 int Si7021::ReadTemp(){
-   int ret = 0;
+   unsigned short code = 0;
 
-  	// send temperature measurement command
-   unsigned char config[1] = {CMD_READ_TEMP_NO_HOLD};
-	write(_fd, config, 1); 
-   this_thread::sleep_for(chrono::milliseconds(WAIT_READ_MS));
+   if(ReadMeasurement(CMD_READ_TEMP_HOLD, CMD_READ_TEMP_NO_HOLD, code, "temperature read error") != 0) 
+      return -1;
 
-	// read 2 bytes of temperature data, data[0]=msb, data[1]=lsb
-   char data[2] = {0};
-	if(read(_fd, data, 2) != 2) {
-      ret = -1;
-		_error = "temperature read error";
-	}
-	else {
-      int combined = ((static_cast<int>(data[0]) << 8) + data[1]);
-		_temperature = ((combined * 175.72) / 65536.0) - 46.85;
-	} // end if 
- 
-   return ret;
+   _temperature = ((code * 175.72) / 65536.0) - 46.85;
+   return 0;
 } // end ReadTemp
 
 
+// the temperature of the humidity conversion, a register read
+int Si7021::ReadTempFromRh(){
+   unsigned char command = CMD_READ_TEMP_FROM_RH;
+   unsigned char data[2] = {0};
+
+   if(WriteRead(&command, 1, data, 2, "temperature read error") != 0) 
+      return -1;
+
+   unsigned short code = (static_cast<unsigned short>(data[0]) << 8) | data[1];
+   _temperature = ((code * 175.72) / 65536.0) - 46.85;
+   return 0;
+} // end ReadTempFromRh
+
+
+// hold mode is one write/read transaction that waits on the clock
+// stretch, no hold writes the command then polls the read until the
+// sensor stops NACKing it. data[0]=msb, data[1]=lsb, data[2]=crc
+int Si7021::ReadMeasurement(unsigned char holdCommand, unsigned char noHoldCommand, 
+                            unsigned short &code, const char *what) {
+   unsigned char data[3] = {0};
+
+   if(_holdMode == true) {
+      if(WriteRead(&holdCommand, 1, data, 3, what) != 0) return -1;
+   }
+   else {
+      if(WriteBytes(&noHoldCommand, 1, what) != 0) return -1;
+      this_thread::sleep_for(chrono::milliseconds(SI7021_CONVERSION_MS));
+
+      int tries = 0;
+      while(ReadBytes(data, 3, what) != 0) {
+         if(++tries == SI7021_READ_TRIES) return -1;
+         this_thread::sleep_for(chrono::milliseconds(SI7021_POLL_MS));
+      } // end while
+   } // end if 
+
+   if(_checkCrc == true && Crc8(data, 2) != data[2]) {
+      _error = string(what) + ": bad checksum";
+      return -1;
+   } // end if 
+
+   _error = "";
+   code = (static_cast<unsigned short>(data[0]) << 8) | data[1];
+   return 0;
+} // end ReadMeasurement
+
+
+unsigned char Si7021::Crc8(const unsigned char *data, size_t length) {
+   unsigned char crc = 0;
+
+   for(size_t i = 0; i < length; ++i) {
+      crc ^= data[i];
+      for(int bit = 0; bit < 8; ++bit) {
+         crc = (crc & 0x80) != 0 ? static_cast<unsigned char>((crc << 1) ^ SI7021_CRC_POLYNOMIAL) : static_cast<unsigned char>(crc << 1);
+      } // end for
+   } // end for
+
+   return crc;
+} // end Crc8
+
+
 string Si7021::HumidityToString(){
    string ret;
 
@@ -105,9 +146,10 @@ int Si7021::ReadSensor(enum SI7021_READINGS reading){
 
       switch(reading){
       case SI7021_READINGS::Both: 
+         // one conversion, the temperature is read back from it
          result = ReadHumidity();
          if(result == 0) 
-            result = ReadTemp();
+            result = ReadTempFromRh();
 
          break;
       case SI7021_READINGS::HumidityOnly: 
@@ -120,7 +162,6 @@ int Si7021::ReadSensor(enum SI7021_READINGS reading){
          break;
       } // end switch
 
-      result = Close();
    } // end if
 
    if(result != 0) {
@@ -26,7 +26,22 @@ const unsigned char SI7021_I2C_ADDRESS = 0x40;
 const unsigned char CMD_READ_HUMIDITY_NO_HOLD = 0xF5;
 const unsigned char CMD_READ_TEMP_NO_HOLD = 0xF3;
 
-const int WAIT_READ_MS = 1000;
+// hold master, the sensor stretches the clock until the conversion is done
+const unsigned char CMD_READ_HUMIDITY_HOLD = 0xE5;
+const unsigned char CMD_READ_TEMP_HOLD = 0xE3;
+
+// the temperature the last humidity conversion measured, no conversion
+// and no checksum byte
+const unsigned char CMD_READ_TEMP_FROM_RH = 0xE0;
+
+// crc-8 of the measurement bytes, x^8 + x^5 + x^4 + 1, init 0
+const unsigned char SI7021_CRC_POLYNOMIAL = 0x31;
+
+// no hold reads, a humidity conversion (it measures the temperature too)
+// is 22.8 ms max, the sensor NACKs the read until it is done
+const int SI7021_CONVERSION_MS = 20;
+const int SI7021_POLL_MS = 5;
+const int SI7021_READ_TRIES = 10;
 
 enum class SI7021_READINGS : int {
    Both = 0,
@@ -40,6 +55,11 @@ public:
    Si7021();
    ~Si7021();
 
+   // holdMode reads in one clock stretched transaction, the pi i2c
+   // controller mishandles some stretching so it is off by default.
+   // checkCrc rejects a measurement with a bad checksum byte
+   void SetOptions(bool holdMode, bool checkCrc) { _holdMode = holdMode; _checkCrc = checkCrc; }
+
    int operator()(enum SI7021_READINGS reading);
    int ReadSensor(enum SI7021_READINGS reading);
 
@@ -55,10 +75,17 @@ private:
 
    float _humidity;
    float _temperature;
+   bool _holdMode;
+   bool _checkCrc;
 
-   // read individuals  
+   // read individuals, ReadTempFromRh() is after a ReadHumidity()
    int ReadHumidity();
    int ReadTemp();
+   int ReadTempFromRh();
+
+   // a measurement command and its 16 bit result 
+   int ReadMeasurement(unsigned char holdCommand, unsigned char noHoldCommand, unsigned short &code, const char *what);
+   static unsigned char Crc8(const unsigned char *data, size_t length);
 
 }; // end class
 
@@ -6,6 +6,8 @@ Si7021Reader::Si7021Reader() {
 
 
 Si7021Reader::~Si7021Reader() {
+   // RunTask() may be running on the reader pool
+   CancelRead();
 } // end dtor 
 
 
@@ -15,9 +17,9 @@ int Si7021Reader::RunTask() {
    int result = _sensor.ReadSensor(SI7021_READINGS::Both);
    if(result == 0) {
 
-      _sensorData.temperature = _sensor.TempToString(false);
+      _sensorData.temperature = _sensor.GetTempReading(false);
       _sensorData.TemperatureUnits = _sensor.GetTemperatureUnits(false); 
-      _sensorData.humidity = _sensor.HumidityToString();
+      _sensorData.humidity = _sensor.GetHumidityReading();
       _sensorData.humidityUnits = _sensor.GetHumidityUnits();
 
       // required call to parent 
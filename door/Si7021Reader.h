@@ -18,11 +18,11 @@ using namespace std;
 // _status = ReaderStatus::Error;
 
 
-// data from the sensor 
+// data from the sensor, numbers so the database stores them as REAL
 struct Si7021Data {
-   string humidity;
+   float humidity;
    string humidityUnits;
-   string temperature;
+   float temperature;
    string TemperatureUnits;
 }; // end struct
 
@@ -34,6 +34,9 @@ public:
    int RunTask() override;
    Si7021Data GetData();
 
+   // see Si7021::SetOptions(), set before the first read
+   void SetOptions(bool holdMode, bool checkCrc) { _sensor.SetOptions(holdMode, checkCrc); }
+
 private:
 
    Si7021 _sensor;
@@ -0,0 +1,138 @@
+#include "SolarCalc.h"
+#include <cmath>
+
+
+namespace {
+
+const double PI = 3.14159265358979323846;
+
+inline double Radians(double deg) { return deg * PI / 180.0; }
+inline double Degrees(double rad) { return rad * 180.0 / PI; }
+
+// julian day at 0h utc of the date
+inline double JulianDay(const date &day) {
+   return static_cast<double>(day.julian_day()) - 0.5;
+}
+
+} // end namespace
+
+
+SolarCalc::SolarCalc(double latitude, double longitude) {
+   _latitude = latitude;
+   _longitude = longitude;
+} // end ctor
+
+
+int SolarCalc::Calc(const date &day, SolarEvents &events) {
+
+   if(day.is_special() == true) {
+      _errorStr = "solar calc: not a date";
+      return -1;
+   } // end if
+
+   double jd0 = JulianDay(day);
+   ptime midnight(day);
+
+   // a minute offset as a ptime, rounded to the second
+   auto AtMinutes = [&midnight](double minutes) {
+      return midnight + seconds(static_cast<long>(lround(minutes * 60.0)));
+   };
+
+   double transit = TransitMinutes(jd0);
+   events.transit = AtMinutes(transit);
+
+   double rise = 0.0, set = 0.0;
+   events.hasRiseSet = EventMinutes(jd0, transit, SOLAR_ZENITH_RISE_SET, true, rise) == true &&
+                       EventMinutes(jd0, transit, SOLAR_ZENITH_RISE_SET, false, set) == true;
+   if(events.hasRiseSet == true) {
+      events.rise = AtMinutes(rise);
+      events.set = AtMinutes(set);
+   } // end if
+
+   double dawn = 0.0, dusk = 0.0;
+   events.hasCivil = EventMinutes(jd0, transit, SOLAR_ZENITH_CIVIL, true, dawn) == true &&
+                     EventMinutes(jd0, transit, SOLAR_ZENITH_CIVIL, false, dusk) == true;
+   if(events.hasCivil == true) {
+      events.civilDawn = AtMinutes(dawn);
+      events.civilDusk = AtMinutes(dusk);
+   } // end if
+
+   if(events.hasRiseSet == false) {
+      _errorStr = "solar calc: no sunrise or sunset on " + to_iso_extended_string(day);
+      return -1;
+   } // end if
+
+   return 0;
+} // end Calc
+
+
+// solar noon, the equation of time is taken at the noon estimate then
+// once more at the result
+double SolarCalc::TransitMinutes(double jd0) {
+   double eqTime = 0.0, declination = 0.0;
+
+   double minutes = 720.0 - 4.0 * _longitude;
+   for(int i = 0; i < 2; ++i) {
+      SunPosition(jd0 + minutes / 1440.0, eqTime, declination);
+      minutes = 720.0 - 4.0 * _longitude - eqTime;
+   } // end for
+
+   return minutes;
+} // end TransitMinutes
+
+
+// the hour angle of the zenith from the declination at the event, two
+// passes from the transit estimate are well inside a minute
+bool SolarCalc::EventMinutes(double jd0, double transitMin, double zenith, bool rising, double &minutes) {
+   double eqTime = 0.0, declination = 0.0;
+   double latitude = Radians(_latitude);
+
+   minutes = transitMin;
+   for(int i = 0; i < 3; ++i) {
+      SunPosition(jd0 + minutes / 1440.0, eqTime, declination);
+
+      double cosHa = cos(Radians(zenith)) / (cos(latitude) * cos(declination)) - tan(latitude) * tan(declination);
+      if(cosHa > 1.0 || cosHa < -1.0) return false;
+
+      double ha = Degrees(acos(cosHa));
+      double noon = 720.0 - 4.0 * _longitude - eqTime;
+      minutes = rising == true ? noon - 4.0 * ha : noon + 4.0 * ha;
+   } // end for
+
+   return true;
+} // end EventMinutes
+
+
+// NOAA solar calculator, see https://gml.noaa.gov/grad/solcalc/calcdetails.html
+void SolarCalc::SunPosition(double jd, double &eqTimeMin, double &declination) {
+
+   double t = (jd - 2451545.0) / 36525.0;   // julian century
+
+   double meanLong = fmod(280.46646 + t * (36000.76983 + t * 0.0003032), 360.0);
+   double meanAnom = 357.52911 + t * (35999.05029 - 0.0001537 * t);
+   double eccent = 0.016708634 - t * (0.000042037 + 0.0000001267 * t);
+
+   double m = Radians(meanAnom);
+   double center = sin(m) * (1.914602 - t * (0.004817 + 0.000014 * t)) +
+                   sin(2.0 * m) * (0.019993 - 0.000101 * t) +
+                   sin(3.0 * m) * 0.000289;
+
+   double omega = Radians(125.04 - 1934.136 * t);
+   double appLong = meanLong + center - 0.00569 - 0.00478 * sin(omega);
+
+   double meanObliq = 23.0 + (26.0 + (21.448 - t * (46.815 + t * (0.00059 - t * 0.001813))) / 60.0) / 60.0;
+   double obliq = Radians(meanObliq + 0.00256 * cos(omega));
+
+   declination = asin(sin(obliq) * sin(Radians(appLong)));
+
+   double y = tan(obliq / 2.0);
+   y *= y;
+   double l0 = Radians(meanLong);
+
+   double eq = y * sin(2.0 * l0) - 2.0 * eccent * sin(m) +
+               4.0 * eccent * y * sin(m) * cos(2.0 * l0) -
+               0.5 * y * y * sin(4.0 * l0) - 1.25 * eccent * eccent * sin(2.0 * m);
+
+   eqTimeMin = 4.0 * Degrees(eq);
+
+} // end SunPosition
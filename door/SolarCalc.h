@@ -0,0 +1,79 @@
+/// file: SolarCalc.h header for SolarCalc class
+/// author: Bennett Cook
+/// date: 10-17-2026
+/// description: sunrise, sunset, upper transit and civil twilight for a
+/// latitude/longitude and a date, computed in process with the NOAA solar
+/// calculator equations (Meeus based, good to about a minute between
+/// +/- 72 deg latitude). Replaces the curl calls to the census geocoder
+/// and the Navy rise/set api, no network, subprocess or temp file.
+/// The refraction and sun radius are in the 90.833 deg zenith of rise
+/// and set, civil twilight is the 96 deg zenith.
+/// usage: SolarCalc sc(42.2, -86.3); SolarEvents ev; sc.Calc(date(2022, 7, 30), ev);
+
+
+// header guard
+#ifndef SOLARCALC_H
+#define SOLARCALC_H
+
+#include <string>
+#include "boost/date_time/posix_time/posix_time.hpp"
+#include <boost/date_time/gregorian/gregorian.hpp>
+
+using namespace std;
+using namespace boost::posix_time;
+using namespace boost::gregorian;
+
+
+// zenith angles in degrees
+const double SOLAR_ZENITH_RISE_SET = 90.833;
+const double SOLAR_ZENITH_CIVIL = 96.0;
+
+
+// all times are utc, the events of the solar day around the upper transit
+// of the date at the longitude, west of greenwich the sunset is on the next
+// utc date. hasRiseSet and hasCivil are false when the sun stays above or
+// below the zenith all day (polar day or night), the times are then not set
+struct SolarEvents {
+   ptime transit;
+   ptime rise;
+   ptime set;
+   ptime civilDawn;
+   ptime civilDusk;
+   bool hasRiseSet;
+   bool hasCivil;
+}; // end struct
+
+
+class SolarCalc {
+public:
+
+   // latitude north positive, longitude east positive, both in degrees
+   SolarCalc(double latitude, double longitude);
+   ~SolarCalc() {}
+
+   // the events of day, 0 with rise and set, -1 if the sun doesn't rise
+   // or set that day, the transit is always set
+   int Calc(const date &day, SolarEvents &events);
+
+   string GetErrorStr() { return _errorStr; }
+
+private:
+
+   double _latitude;
+   double _longitude;
+   string _errorStr;
+
+   // minutes from 0h utc of the julian day jd0 for the zenith, rising is
+   // true for the morning event, false if the sun doesn't reach zenith
+   bool EventMinutes(double jd0, double transitMin, double zenith, bool rising, double &minutes);
+
+   // utc minutes of the upper transit on the julian day jd0
+   double TransitMinutes(double jd0);
+
+   // equation of time in minutes and declination in radians at jd
+   static void SunPosition(double jd, double &eqTimeMin, double &declination);
+
+}; // end class
+
+
+#endif // end header guard
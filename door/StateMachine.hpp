@@ -14,6 +14,7 @@
 #include <vector>
 #include <boost/sml.hpp>
 #include <boost/mpl/placeholders.hpp>
+#include <boost/assert.hpp>
 
 #include "Rp4bPwm.h"
 #include "CommonDef.h"
@@ -79,6 +80,17 @@ public:
 
    explicit sm_chicken_coop(IoValues &ioValues, AppConfig &ac, Rp4bPwm &pwm, NoBlockTimer &nbTimer) :
       _ioValues(ioValues), _ac(ac), _pwm(pwm), _nbTimer(nbTimer) {
+
+      // resolve the io names once, the guards and actions use the handles
+      _up = _ioValues.Handle("up");
+      _down = _ioValues.Handle("down");
+      _obstructed = _ioValues.Handle("obstructed");
+      _direction = _ioValues.Handle("direction");
+      _enable = _ioValues.Handle("enable");
+
+      BOOST_ASSERT_MSG(_up != INVALID_IO_HANDLE && _down != INVALID_IO_HANDLE &&
+                       _obstructed != INVALID_IO_HANDLE && _direction != INVALID_IO_HANDLE &&
+                       _enable != INVALID_IO_HANDLE, "state machine io name not in the configuration");
    } // end ctor 
 
    // callback to set outputs in main()
@@ -95,15 +107,15 @@ public:
 
       // guards
       auto AtUp = [this] () -> bool {
-         return (_ioValues["up"] == 0);
+         return (_ioValues.Get(_up) == 0);
       }; // end AtUp
 
       auto AtDown = [this] () -> bool {
-         return (_ioValues["down"] == 0);
+         return (_ioValues.Get(_down) == 0);
       }; // end AtDown
 
       auto Obstructed = [this] () -> bool {
-         return (_ioValues["obstructed"] == 0);
+         return (_ioValues.Get(_obstructed) == 0);
       }; // end Obstructed
 
       auto TimerDone = [this] () -> bool {
@@ -125,49 +137,50 @@ public:
       return make_transition_table (
 
          // start homing 
-         *state<Idle1> + event<eInit> / [&] { PrintLn("HomingSlowUp state"); } = state<HomingSlowUp>,
-         state<HomingSlowUp> + sml::on_entry<_> / [&] {PrintLn("HomingSlowUp on_entry");  _cb(DoorState::Startup); MotorDirection(MoveUp); MotorSpeed(_ac.pwmHzHoming); MotorEnable(true); StartTimer(30000);},
-         state<HomingSlowUp> + sml::on_exit<_> / [&] {PrintLn("HomingSlowUp on_exit"); MotorSpeed(0); },
-         state<HomingSlowUp> + event<eStartUp>[AtUp] / [&] {PrintLn("HomingDown state"); KillTimer(); } = state<HomingDown>,
-         state<HomingSlowUp> + event<eStartUp>[TimerDone] / [&] {PrintLn("Failed1");  MotorSpeed(0);} = state<Failed>,
+         *state<Idle1> + event<eInit> / [&] { Log(LogLevel::Info, LogEvent::StateAction, "HomingSlowUp state"); } = state<HomingSlowUp>,
+         state<HomingSlowUp> + sml::on_entry<_> / [&] {Log(LogLevel::Info, LogEvent::StateAction, "HomingSlowUp on_entry");  _cb(DoorState::Startup); MotorDirection(MoveUp); MotorSpeed(_ac.pwmHzHoming); MotorEnable(true); StartTimer(30000);},
+         state<HomingSlowUp> + sml::on_exit<_> / [&] {Log(LogLevel::Info, LogEvent::StateAction, "HomingSlowUp on_exit"); MotorSpeed(0); },
+         state<HomingSlowUp> + event<eStartUp>[AtUp] / [&] {Log(LogLevel::Info, LogEvent::StateAction, "HomingDown state"); KillTimer(); } = state<HomingDown>,
+         state<HomingSlowUp> + event<eStartUp>[TimerDone] / [&] {Log(LogLevel::Info, LogEvent::StateAction, "Failed1");  MotorSpeed(0);} = state<Failed>,
 
-         state<HomingDown> + sml::on_entry<_> / [&] {PrintLn("HomingDown on_entry"); MotorDirection(MoveDown); MotorSpeed(_ac.pwmHzHoming); StartTimer(1500);},
-         state<HomingDown> + sml::on_exit<_> / [&] {PrintLn("HomingDown on_exit"); MotorSpeed(0); },
-         state<HomingDown> + event<eStartUp>[TimerDone] / [&] {PrintLn("HomingUp state"); KillTimer();} = state<HomingUp>,
+         state<HomingDown> + sml::on_entry<_> / [&] {Log(LogLevel::Info, LogEvent::StateAction, "HomingDown on_entry"); MotorDirection(MoveDown); MotorSpeed(_ac.pwmHzHoming); StartTimer(1500);},
+         state<HomingDown> + sml::on_exit<_> / [&] {Log(LogLevel::Info, LogEvent::StateAction, "HomingDown on_exit"); MotorSpeed(0); },
+         state<HomingDown> + event<eStartUp>[TimerDone] / [&] {Log(LogLevel::Info, LogEvent::StateAction, "HomingUp state"); KillTimer();} = state<HomingUp>,
 
          state<HomingUp> + sml::on_entry<_> / [&] { MotorDirection(MoveUp); MotorSpeed(_ac.pwmHzSlow); StartTimer(2000);},
          state<HomingUp> + sml::on_exit<_> / [&] {MotorSpeed(0); },
-         state<HomingUp> + event<eStartUp>[AtUp] / [&] {PrintLn("HomingComplete"); MotorSpeed(0); KillTimer();} = state<HomingComplete>,
-         state<HomingUp> + event<eStartUp>[TimerDone] / [&] {PrintLn("Failed2");  MotorSpeed(0);} = state<Failed>,
-         state<HomingComplete> + event<eOnTime>[ReturnTrue] / [&] {PrintLn("Open from HomingComplete");  MotorSpeed(0);} = state<Open>, 
+         state<HomingUp> + event<eStartUp>[AtUp] / [&] {Log(LogLevel::Info, LogEvent::StateAction, "HomingComplete"); MotorSpeed(0); KillTimer();} = state<HomingComplete>,
+         state<HomingUp> + event<eStartUp>[TimerDone] / [&] {Log(LogLevel::Info, LogEvent::StateAction, "Failed2");  MotorSpeed(0);} = state<Failed>,
+         state<HomingComplete> + event<eOnTime>[ReturnTrue] / [&] {Log(LogLevel::Info, LogEvent::StateAction, "Open from HomingComplete");  MotorSpeed(0);} = state<Open>, 
          // note the eOnTime is sent for HomingComplete when light data is available
          // end homing 
 
          // normal sequence 
          state<Closed> + sml::on_entry<_> / [&] {_cb(DoorState::Closed); MotorSpeed(0); },
-         state<Closed> + event<eOnTime>[IsDay] / [] {PrintLn("MovingToOpen");} = state<MovingToOpen>,
+         state<Closed> + event<eOnTime>[IsDay] / [] {Log(LogLevel::Info, LogEvent::StateAction, "MovingToOpen");} = state<MovingToOpen>,
 
          state<MovingToOpen> + sml::on_entry<_> / [&] {_cb(DoorState::MovingToOpen); MotorDirection(MoveUp); MotorSpeed(_ac.pwmHzFast); StartTimer(30000);},
-         state<MovingToOpen> + event<eOnTime>[AtUp] / [&] {PrintLn("Open"); KillTimer();} = state<Open>,
-         state<MovingToOpen> + event<eOnTime>[TimerDone] / [&] {PrintLn("Failed3");  MotorSpeed(0);} = state<Failed>,
+         state<MovingToOpen> + event<eOnTime>[AtUp] / [&] {Log(LogLevel::Info, LogEvent::StateAction, "Open"); KillTimer();} = state<Open>,
+         state<MovingToOpen> + event<eOnTime>[TimerDone] / [&] {Log(LogLevel::Info, LogEvent::StateAction, "Failed3");  MotorSpeed(0);} = state<Failed>,
 
          state<Open> + sml::on_entry<_> / [&] {_cb(DoorState::Open); MotorSpeed(0); },
-         state<Open> + event<eOnTime>[IsNight] / [&] {PrintLn("MovingToClose"); KillTimer();} = state<MovingToClose>,
-         state<Open> + event<eOnTime>[TimerDone] / [&] {PrintLn("Failed4");  MotorSpeed(0);} = state<Failed>,
+         state<Open> + event<eOnTime>[IsNight] / [&] {Log(LogLevel::Info, LogEvent::StateAction, "MovingToClose"); KillTimer();} = state<MovingToClose>,
+         state<Open> + event<eOnTime>[TimerDone] / [&] {Log(LogLevel::Info, LogEvent::StateAction, "Failed4");  MotorSpeed(0);} = state<Failed>,
 
          state<MovingToClose> + sml::on_entry<_> / [&] {_cb(DoorState::MovingToClose); MotorDirection(MoveDown); MotorSpeed(_ac.pwmHzSlow); StartTimer(30000);},
-         state<MovingToClose> + event<eOnTime>[AtDown] / [&] {PrintLn("ClosedLock"); KillTimer(); StartTimer(1500);} = state<ClosedLock>,
-         state<ClosedLock> + event<eOnTime>[TimerDone] / [&] {PrintLn("Closed"); KillTimer();} = state<Closed>,
-         state<MovingToClose> + event<eOnTime>[TimerDone] / [&] {PrintLn("Failed5"); MotorSpeed(0);} = state<Failed>,
+         state<MovingToClose> + event<eOnTime>[AtDown] / [&] {Log(LogLevel::Info, LogEvent::StateAction, "ClosedLock"); KillTimer(); StartTimer(1500);} = state<ClosedLock>,
+         state<ClosedLock> + event<eOnTime>[TimerDone] / [&] {Log(LogLevel::Info, LogEvent::StateAction, "Closed"); KillTimer();} = state<Closed>,
+         state<MovingToClose> + event<eOnTime>[TimerDone] / [&] {Log(LogLevel::Info, LogEvent::StateAction, "Failed5"); MotorSpeed(0);} = state<Failed>,
 
          // obstruction
-         state<MovingToClose> + event<eOnTime>[Obstructed] / [&] {PrintLn("ObstructionDetected"); KillTimer();} = state<ObstructionDetected>,
-         state<ObstructionDetected> + event<eOnTime>[ReturnTrue] / [] {PrintLn("ObstructionPause"); } = state<ObstructionPause>,
+         // stop the motor here, not on ObstructionPause entry one event later
+         state<MovingToClose> + event<eOnTime>[Obstructed] / [&] {MotorSpeed(0); Log(LogLevel::Info, LogEvent::StateAction, "ObstructionDetected"); KillTimer();} = state<ObstructionDetected>,
+         state<ObstructionDetected> + event<eOnTime>[ReturnTrue] / [] {Log(LogLevel::Info, LogEvent::StateAction, "ObstructionPause"); } = state<ObstructionPause>,
          state<ObstructionPause> + sml::on_entry<_> / [&] {_cb(DoorState::Obstructed); MotorSpeed(0); StartTimer(3000);},
-         state<ObstructionPause> + event<eOnTime>[TimerDone] / [&] {PrintLn("PauseDone"); KillTimer();} = state<PauseDone>,
+         state<ObstructionPause> + event<eOnTime>[TimerDone] / [&] {Log(LogLevel::Info, LogEvent::StateAction, "PauseDone"); KillTimer();} = state<PauseDone>,
 
-         state<PauseDone> + event<eOnTime>[Obstructed] / [] {PrintLn("MovingToOpen");} = state<MovingToOpen>,
-         state<PauseDone> + event<eOnTime>[!Obstructed] / [] {PrintLn("MovingToClose");} = state<MovingToClose>
+         state<PauseDone> + event<eOnTime>[Obstructed] / [] {Log(LogLevel::Info, LogEvent::StateAction, "MovingToOpen");} = state<MovingToOpen>,
+         state<PauseDone> + event<eOnTime>[!Obstructed] / [] {Log(LogLevel::Info, LogEvent::StateAction, "MovingToClose");} = state<MovingToClose>
 
       );
 
@@ -177,30 +190,41 @@ private:
 
    std::function<void(DoorState ds)> _cb;
    IoValues &_ioValues;
+   IoHandle _up;
+   IoHandle _down;
+   IoHandle _obstructed;
+   IoHandle _direction;
+   IoHandle _enable;
    AppConfig &_ac;
    Rp4bPwm &_pwm;
    NoBlockTimer &_nbTimer;
 
    void MotorDirection(unsigned dir) {
-      _ioValues["direction"] = static_cast<unsigned>(dir ? 1 : 0);
+      _ioValues.Set(_direction, dir ? 1u : 0u);
    } // end MotorDirection
 
    void MotorSpeed(int hz) {
 
-      // use hz to enable/disable the pwn output 
+      // use hz to enable/disable the pwn output, the frequency is set
+      // before the enable so the motor starts at the new speed
+      int result = 0;
       if(hz > 0){
-         _pwm.SetFrequenceHz(hz);
-         _pwm.Enable(true);
+         result = _pwm.SetFrequenceHz(hz);
+         if(result == 0) result = _pwm.Enable(true);
       }
       else {
-         _pwm.Enable(false);
+         result = _pwm.Enable(false);
+      } // end if
+
+      if(result != 0) {
+         Log(LogLevel::Error, LogEvent::PwmError, _pwm.GetErrStr());
       } // end if
 
-      PrintLn((boost::format{ "motor speed: %d" } %  hz).str());
+      Log(LogLevel::Info, LogEvent::MotorSpeed, hz);
    } // end MotorSpeed
 
    void MotorEnable(bool state) {
-      _ioValues["enable"] = static_cast<unsigned>(state == true ? 0 : 1);
+      _ioValues.Set(_enable, state == true ? 0u : 1u);
    }  // end MotorEnable 
 
    void KillTimer() {
@@ -0,0 +1,233 @@
+#include "SunTable.h"
+#include <unistd.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <cerrno>
+#include <cmath>
+#include <cstring>
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+
+
+SunTable::SunTable() {
+   _table = nullptr;
+} // end ctor
+
+
+SunTable::~SunTable() {
+   Close();
+} // end dtor
+
+
+int SunTable::Open(const string &path, double latitude, double longitude) {
+
+   Close();
+
+   time_t now = time(nullptr);
+   tm utc;
+   gmtime_r(&now, &utc);
+   int year = LeapYearFor(utc.tm_year + 1900);
+
+   // up to 2 tries, map it as it is then generate it and map again
+   for(int i = 0; i < 2; ++i) {
+
+      int fd = open(path.c_str(), O_RDONLY | O_CLOEXEC);
+      if(fd >= 0) {
+         void *mem = MAP_FAILED;
+         off_t size = lseek(fd, 0, SEEK_END);
+         if(size == static_cast<off_t>(sizeof(SunTableFile))) {
+            mem = mmap(nullptr, sizeof(SunTableFile), PROT_READ, MAP_SHARED, fd, 0);
+         } // end if
+         close(fd);
+
+         if(mem != MAP_FAILED) {
+            _table = static_cast<SunTableFile *>(mem);
+            const SunTableHeader &h = _table->header;
+
+            // the location to about 100m
+            if(memcmp(h.magic, SUN_TABLE_MAGIC, sizeof(h.magic)) == 0 && h.days == SUN_TABLE_DAYS &&
+               h.year == year && fabs(h.latitude - latitude) < 0.001 && fabs(h.longitude - longitude) < 0.001) {
+               return 0;
+            } // end if
+
+            Close();
+         } // end if
+      } // end if
+
+      if(i == 0 && Generate(path, latitude, longitude, year) != 0) return -1;
+   } // end for
+
+   _errorStr = "sun table " + path + " doesn't match after it was generated";
+   return -1;
+} // end Open
+
+
+void SunTable::Close() {
+
+   if(_table == nullptr) return;
+
+   munmap(_table, sizeof(SunTableFile));
+   _table = nullptr;
+
+} // end Close
+
+
+int SunTable::Generate(const string &path, double latitude, double longitude, int year) {
+
+   if(gregorian_calendar::is_leap_year(static_cast<unsigned short>(year)) == false) {
+      _errorStr = "sun table year " + to_string(year) + " is not a leap year";
+      return -1;
+   } // end if
+
+   SunTableFile file{};
+   memcpy(file.header.magic, SUN_TABLE_MAGIC, sizeof(file.header.magic));
+   file.header.days = SUN_TABLE_DAYS;
+   file.header.year = year;
+   file.header.latitude = latitude;
+   file.header.longitude = longitude;
+
+   SolarCalc solarCalc(latitude, longitude);
+   date day(static_cast<unsigned short>(year), 1, 1);
+
+   // minutes from 0h utc of day, rounded
+   auto Minutes = [&day](const ptime &pt, bool valid) {
+      if(valid == false) return SUN_TABLE_NONE;
+      return static_cast<int16_t>(lround((pt - ptime(day)).total_seconds() / 60.0));
+   };
+
+   for(size_t i = 0; i < SUN_TABLE_DAYS; ++i, day += days(1)) {
+      SolarEvents events;
+      solarCalc.Calc(day, events);
+
+      SunTableDay &entry = file.days[i];
+      entry.transit = Minutes(events.transit, true);
+      entry.rise = Minutes(events.rise, events.hasRiseSet);
+      entry.set = Minutes(events.set, events.hasRiseSet);
+      entry.civilDawn = Minutes(events.civilDawn, events.hasCivil);
+      entry.civilDusk = Minutes(events.civilDusk, events.hasCivil);
+   } // end for
+
+   // a reader never sees half a file, write a temp then rename it over
+   string temp = path + ".tmp";
+   {
+      ofstream out(temp, ios::binary | ios::trunc);
+      out.write(reinterpret_cast<const char *>(&file), sizeof(file));
+      if(out.good() == false) {
+         _errorStr = "can not write sun table " + temp + ": " + strerror(errno);
+         return -1;
+      } // end if
+   }
+
+   if(rename(temp.c_str(), path.c_str()) != 0) {
+      _errorStr = "can not rename " + temp + ": " + strerror(errno);
+      return -1;
+   } // end if
+
+   return 0;
+} // end Generate
+
+
+const SunTableDay *SunTable::GetDay(const date &day) {
+
+   if(_table == nullptr || day.is_special() == true) return nullptr;
+
+   return &_table->days[DayIndex(day.year(), day.day_of_year() - 1)];
+} // end GetDay
+
+
+int SunTable::GetTimes(const date &day, SunTimes &times) {
+
+   const SunTableDay *entry = GetDay(day);
+   if(entry == nullptr) {
+      _errorStr = "no sun table";
+      return -1;
+   } // end if
+
+   if(entry->rise == SUN_TABLE_NONE || entry->set == SUN_TABLE_NONE) {
+      _errorStr = "no sunrise or sunset on " + to_iso_extended_string(day);
+      return -1;
+   } // end if
+
+   times.rise = AtMinutes(day, entry->rise);
+   times.set = AtMinutes(day, entry->set);
+   times.transit = AtMinutes(day, entry->transit);
+
+   // civil twilight is missing some summer nights far north, use rise and set
+   times.civilDawn = entry->civilDawn != SUN_TABLE_NONE ? AtMinutes(day, entry->civilDawn) : times.rise;
+   times.civilDusk = entry->civilDusk != SUN_TABLE_NONE ? AtMinutes(day, entry->civilDusk) : times.set;
+
+   return 0;
+} // end GetTimes
+
+
+// the date of t and the dates on each side, west of greenwich the day
+// before's sunset is past 0h utc, far east the next day's rise is before it
+bool SunTable::IsDaytime(time_t t, int riseOffsetMin, int setOffsetMin) {
+
+   if(_table == nullptr) return false;
+
+   tm utc;
+   gmtime_r(&t, &utc);
+
+   int minute = utc.tm_hour * 60 + utc.tm_min;
+   size_t index = DayIndex(static_cast<unsigned>(utc.tm_year + 1900), static_cast<unsigned>(utc.tm_yday));
+
+   for(int offset = -1; offset <= 1; ++offset) {
+      const SunTableDay &entry = _table->days[(index + SUN_TABLE_DAYS + offset) % SUN_TABLE_DAYS];
+      if(entry.rise == SUN_TABLE_NONE || entry.set == SUN_TABLE_NONE) continue;
+
+      // minutes of t from 0h utc of that entry's date
+      int at = minute - offset * 1440;
+      if(at >= entry.rise + riseOffsetMin && at < entry.set + setOffsetMin) return true;
+   } // end for
+
+   return false;
+} // end IsDaytime
+
+
+string SunTable::ToJson(const date &first, unsigned count) {
+   ostringstream out;
+   ptime epoch(date(1970, 1, 1));
+
+   out << '[';
+
+   date day = first;
+   for(unsigned i = 0; i < count; ++i, day += days(1)) {
+      SunTimes times;
+      out << (i == 0 ? "" : ",") << "{\"date\":\"" << to_iso_extended_string(day) << '"';
+
+      if(GetTimes(day, times) == 0) {
+         out << ",\"rise\":" << (times.rise - epoch).total_seconds()
+             << ",\"set\":" << (times.set - epoch).total_seconds()
+             << ",\"transit\":" << (times.transit - epoch).total_seconds()
+             << ",\"civil_dawn\":" << (times.civilDawn - epoch).total_seconds()
+             << ",\"civil_dusk\":" << (times.civilDusk - epoch).total_seconds();
+      } // end if
+
+      out << '}';
+   } // end for
+
+   out << ']';
+   return out.str();
+} // end ToJson
+
+
+// the most recent leap year, 2100 is the first year this gets wrong
+int SunTable::LeapYearFor(int year) {
+   return year - (year % 4);
+} // end LeapYearFor
+
+
+// a non leap year skips Feb 29, index 59 of the table
+size_t SunTable::DayIndex(unsigned year, unsigned dayOfYear) {
+   bool leap = gregorian_calendar::is_leap_year(static_cast<unsigned short>(year));
+
+   if(leap == false && dayOfYear >= 59) ++dayOfYear;
+   return dayOfYear < SUN_TABLE_DAYS ? dayOfYear : SUN_TABLE_DAYS - 1;
+} // end DayIndex
+
+
+ptime SunTable::AtMinutes(const date &day, int16_t minutes) {
+   return ptime(day) + boost::posix_time::minutes(minutes);
+} // end AtMinutes
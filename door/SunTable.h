@@ -0,0 +1,134 @@
+/// file: SunTable.h header for SunTable and Daytime classes
+/// author: Bennett Cook
+/// date: 10-17-2026
+/// description: a year of sun times precomputed with SolarCalc for the
+/// configured location, a 3.7k binary file that is mmapped. A day is 5
+/// int16 minutes from 0h utc of the date (rise, set, transit, civil dawn
+/// and dusk) so "is it daytime at t" is an array index, no calculation.
+/// The days are the 366 days of a leap year, a day of another year reads
+/// the same month and day, the times move less than a minute from year
+/// to year. Open() generates the file again when it is missing or made
+/// for other coordinates or an older leap year cycle.
+/// The suntable tool prints or regenerates the file.
+
+
+// header guard
+#ifndef SUNTABLE_H
+#define SUNTABLE_H
+
+#include <cstdint>
+#include <ctime>
+#include <string>
+#include <boost/core/noncopyable.hpp>
+
+#include "DateTimeUtils.h"
+#include "SolarCalc.h"
+
+using namespace std;
+
+
+const char SUN_TABLE_MAGIC[8] = {'C', 'O', 'O', 'P', 'S', 'U', 'N', '1'};
+const size_t SUN_TABLE_DAYS = 366;
+
+// minutes of an event the day doesn't have (polar day or night)
+const int16_t SUN_TABLE_NONE = INT16_MAX;
+
+
+// minutes from 0h utc of the date, west of greenwich the set is past
+// 1440 (the next utc date), far east the rise is below 0
+struct SunTableDay {
+   int16_t rise;
+   int16_t set;
+   int16_t transit;
+   int16_t civilDawn;
+   int16_t civilDusk;
+}; // end struct
+
+
+struct SunTableHeader {
+   char magic[8];
+   uint32_t days;
+   int32_t year;        // the leap year the table is calculated for
+   double latitude;
+   double longitude;
+}; // end struct
+
+
+struct SunTableFile {
+   SunTableHeader header;
+   SunTableDay days[SUN_TABLE_DAYS];
+}; // end struct
+
+
+class SunTable : private boost::noncopyable {
+public:
+
+   SunTable();
+   ~SunTable();
+
+   // map path, generate it first if it doesn't match the location
+   int Open(const string &path, double latitude, double longitude);
+   void Close();
+   bool IsOpen() { return _table != nullptr; }
+
+   // write the table for the location and the leap year, replaces path
+   int Generate(const string &path, double latitude, double longitude, int year);
+
+   // the utc times of day, -1 without a rise and set that day
+   int GetTimes(const date &day, SunTimes &times);
+
+   // raw entry of the day, nullptr without a table
+   const SunTableDay *GetDay(const date &day);
+
+   // true between rise + riseOffsetMin and set + setOffsetMin, t is utc
+   // epoch. false on a day without a rise or set or without a table
+   bool IsDaytime(time_t t, int riseOffsetMin, int setOffsetMin);
+
+   // the days as a json array, utc epoch seconds, for the web page and charts
+   string ToJson(const date &first, unsigned days);
+
+   const SunTableHeader *GetHeader() { return _table != nullptr ? &_table->header : nullptr; }
+   string GetErrorStr() { return _errorStr; }
+
+   // the leap year the table for year is made for
+   static int LeapYearFor(int year);
+
+private:
+   SunTableFile *_table;
+   string _errorStr;
+
+   // month and day of a date in the leap year table, 0 to 365
+   static size_t DayIndex(unsigned year, unsigned dayOfYear);
+   static ptime AtMinutes(const date &day, int16_t minutes);
+
+}; // end class
+
+
+// all times are in utc epoch from the sun table
+// the offsets are set in the ctor so the class is valid for those initial values only,
+// sunriseOffset and sunsetOffset are read from the configurtion file
+class Daytime {
+public:
+   // params sunriseOffset and sunsetOffset are in minutes
+   Daytime(SunTable &sunTable, int sunriseOffset, int sunsetOffset) :
+      _sunTable(sunTable), _sunriseOffset{sunriseOffset}, _sunsetOffset{sunsetOffset} {
+   } // end ctor
+
+   ~Daytime() {}
+
+   // return true is day time or false not day time
+   int IsDaytime() { return IsDaytime(time(nullptr)); }
+
+   // the same at now, utc epoch from the caller's clock
+   int IsDaytime(time_t now) {
+      return _sunTable.IsDaytime(now, _sunriseOffset, _sunsetOffset) == true ? 1 : 0;
+   } // end IsDaytime
+
+private:
+   SunTable &_sunTable;
+   int _sunriseOffset;
+   int _sunsetOffset;
+}; // end class
+
+
+#endif // end header guard
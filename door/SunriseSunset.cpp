@@ -1,20 +1,18 @@
 #include "SunriseSunset.h"
 
-SunriseSunset::SunriseSunset(const Address &address, const string &updateAt) {
-   Setup(address, updateAt);
+SunriseSunset::SunriseSunset(SunTable &sunTable, TimerService &timers, const string &updateAt) :
+   _sunTable(sunTable), _timers(timers) {
+   Setup(updateAt);
    _status = SunriseSunsetStatus::Initial;
-   _hasCoords = false;
+   _nextRefresh = 0;
+   _timer = _timers.Create("sunrise sunset", [this]() { OnTimer(); });
 } // end ctor 
 
-SunriseSunset::~SunriseSunset() {}
+SunriseSunset::~SunriseSunset() {
+   Stop();
+} // end dtor
 
-int SunriseSunset::Setup(const Address &address, const string &updateAt) {
-
-   _address.house_number = address.house_number;
-   _address.street = address.street;
-   _address.city = address.city;
-   _address.state = address.state;
-   _address.zip_code = address.zip_code;
+int SunriseSunset::Setup(const string &updateAt) {
 
    std::tuple<unsigned, unsigned, unsigned> val;
    int ret = Parse24HrTime(updateAt, val);
@@ -24,172 +22,118 @@ int SunriseSunset::Setup(const Address &address, const string &updateAt) {
    }
    else { // set defaults
       _fetchHour = 2;
-      _fetchHour = 5;
+      _fetchMinute = 10;
    } // end if 
 
    return ret;
 } // end Setup
 
 
-void SunriseSunset::FetchTimes(coroutine<SunriseSunsetStatus>::push_type& out) {
-   _status = SunriseSunsetStatus::Initial;
-   _hasCoords = false;
-
-   LocationReader lr(_address);
-   SunriseSunsetReader sr;
-
-   // continuous loop, coroutine life time controlled by caller,
-   // all "out(_status);" are the "co_await" like returns
-   while(true) {
-
-      // always run on first loop, if successfull just reuse data 
-      // and skip in all later loops
-      if (_hasCoords == false) {
-
-         lr.ReadAfterSec(2);
-         _status = SunriseSunsetStatus::CoordsStarted;
-         out(_status);
-
-         while (lr.GetStatus() == ReaderStatus::Waiting) {
-            out(_status);
-         } // end while
-
-         if (lr.GetStatus() == ReaderStatus::Complete) {
-            _status = SunriseSunsetStatus::CoordsComplete;
-            _hasCoords = true;
-         }
-         else if (lr.GetStatus() == ReaderStatus::Error) {
-            _status = SunriseSunsetStatus::Error;
-            _errorStr = lr.GetError();
-         } // end if
-
-      }
-      else {
-         _status = SunriseSunsetStatus::CoordsComplete;
-      } // end if 
-
-      out(_status);
-
-      // use default times on LocationReader fail
-      if (_status == SunriseSunsetStatus::CoordsComplete) {
-
-         Coordinates data = lr.GetData();
-         sr.SetCoords(data);
-         sr.ReadAfterSec(2);
-         _status = SunriseSunsetStatus::SunRiseSetStarted;
-
-         while (sr.GetStatus() == ReaderStatus::Waiting) {
-            out(_status);
-         } // end while 
-
-         if (sr.GetStatus() == ReaderStatus::Complete) {
-            _status = SunriseSunsetStatus::SunRiseSetComplete;
-            _times = sr.GetData();
-            sr.ResetStatus();
-
-            // _times.Print();
-            
-            // this conversion is multi-step with several possible errors 
-            int result = Convert2Local();
-            if (result != 0) {
-               _status = SunriseSunsetStatus::Error;
-            } // end if 
-
-         }
-         else if (sr.GetStatus() == ReaderStatus::Error) {
-            _status = SunriseSunsetStatus::Error;
-            _errorStr = sr.GetError();
-         } // end if 
-
-         out(_status);
-
-      } // end if
-      
-      _status = SunriseSunsetStatus::WaitForNextDay;
+int SunriseSunset::Start() {
+   time_t now = time(nullptr);
 
-      bool onetime = false;
+   Refresh(now);
+   return Arm(now);
+} // end Start
 
-      // wait here until IsTime() is true 
-      while(_status == SunriseSunsetStatus::WaitForNextDay) {
 
-         if (IsTime(_fetchHour, _fetchMinute) == true) 
-            onetime = true;
+void SunriseSunset::Stop() {
+   _timers.Cancel(_timer);
+} // end Stop
 
-         if(onetime == true && IsTime(_fetchHour, _fetchMinute) != true)
-            _status = SunriseSunsetStatus::Initial;
 
-         out(_status);
-      } // end while
+SunriseSunsetStatus SunriseSunset::Poll() {
+   SunriseSunsetStatus status = _status;
 
-   } // end while
+   if(_status == SunriseSunsetStatus::SunRiseSetComplete || _status == SunriseSunsetStatus::Error)
+      _status = SunriseSunsetStatus::WaitForNextDay;
 
-   return;
-} // end FetchTimes
+   return status;
+} // end Poll
 
 
-int SunriseSunset::Convert2Local() {
-   int result = 0;
+// runs from TimerService::Dispatch(), refresh when the deadline passed or
+// the wall clock moved back more than a day, else wait some more
+void SunriseSunset::OnTimer() {
+   time_t now = time(nullptr);
 
-   std::tuple<unsigned, unsigned, unsigned> val1, val2;
-   ptime utc_sunrise_pt, utc_sunset_pt, utc_upper_transit;
-   time_duration day_length;
+   if(now >= _nextRefresh || _nextRefresh - now > 25 * 60 * 60) Refresh(now);
 
-   // for sunrise
-   result = Parse24HrTime(_times.sunrise, val1);
-   if (result != 0) {
-      _errorStr = "error parsing sunrise string";
-      return -1;
-   } // end if 
+   Arm(now);
+} // end OnTimer
 
-   // cout << "hour: " << get<0>(val1) << ", minute: " << get<1>(val1) << ", second: " << get<2>(val1) << endl;
 
-   // for upper transit
-   result = Parse24HrTime(_times.upper_transit, val2);
-   if (result != 0) {
-      _errorStr = "error parsing upper transit string";
-      return -1;
+void SunriseSunset::Refresh(time_t now) {
+
+   if (CalcLocalTimes() == 0) {
+      _status = SunriseSunsetStatus::SunRiseSetComplete;
+   }
+   else {
+      _status = SunriseSunsetStatus::Error;
    } // end if 
 
-   // cout << "hour: " << get<0>(val2) << ", minute: " << get<1>(val2) << ", second: " << get<2>(val2) << endl;
+   _nextRefresh = NextRefresh(now);
+} // end Refresh
 
-   result = MakePTimeFrom(get<0>(val1), get<1>(val1), get<2>(val1), utc_sunrise_pt);
-   if (result != 0) {
-      _errorStr = "error on sunrise values to ptime";
+
+// wait for the refresh deadline, at most SUN_RECHECK_MS
+int SunriseSunset::Arm(time_t now) {
+   unsigned ms = SUN_RECHECK_MS;
+   if(_nextRefresh > now && _nextRefresh - now < SUN_RECHECK_MS / 1000)
+      ms = static_cast<unsigned>(_nextRefresh - now) * 1000;
+
+   if(_timers.Start(_timer, ms) != 0) {
+      _errorStr = _timers.GetErrorStr();
       return -1;
    } // end if 
 
-   result = MakePTimeFrom(get<0>(val2), get<1>(val2), get<2>(val2), utc_upper_transit);
-   if (result != 0) {
-      _errorStr = "error on upper_transit values to ptime";
-      return -1;
+   return 0;
+} // end Arm
+
+
+// the next fetch hour:minute local time after now, mktime() sorts out
+// the month end and dst
+time_t SunriseSunset::NextRefresh(time_t now) {
+   tm local;
+   localtime_r(&now, &local);
+
+   local.tm_hour = static_cast<int>(_fetchHour);
+   local.tm_min = static_cast<int>(_fetchMinute);
+   local.tm_sec = 0;
+   local.tm_isdst = -1;
+   time_t next = mktime(&local);
+
+   if(next <= now) {
+      localtime_r(&now, &local);
+      local.tm_mday += 1;
+      local.tm_hour = static_cast<int>(_fetchHour);
+      local.tm_min = static_cast<int>(_fetchMinute);
+      local.tm_sec = 0;
+      local.tm_isdst = -1;
+      next = mktime(&local);
    } // end if 
 
-   // the upper_transit is the time when the sun is at it's highest point 
-   // when is 1/2 between sunrise and sunset. 
-   // calc 1/2 day duration and double it for day_length  
-   time_duration td = utc_upper_transit - utc_sunrise_pt;
-   td *= 2;
-   day_length = td;
+   return next;
+} // end NextRefresh
 
-   result = CalcSunset(utc_sunrise_pt, day_length, utc_sunset_pt);
-   if (result != 0) {
-      _errorStr = "error on calculating sunset";
-      return -1;
-   } // end if 
 
-   result = ToLocalTime(utc_sunrise_pt, _localTimes.rise);
-   if (result != 0) {
-      _errorStr = "error on convert sunrise to local time";
-      return -1;
-   } // end if 
+// today's sun times from the table, converted to local time 
+int SunriseSunset::CalcLocalTimes() {
+   SunTimes utcTimes;
+
+   date today = second_clock::local_time().date();
 
-   result = ToLocalTime(utc_sunset_pt, _localTimes.set);
+   int result = _sunTable.GetTimes(today, utcTimes);
    if (result != 0) {
-      _errorStr = "error on convert sunset to local time";
+      _errorStr = _sunTable.GetErrorStr();
       return -1;
    } // end if 
 
-   return 0;
-} // end Convert2Local
-
+   ToLocalTime(utcTimes.rise, _localTimes.rise);
+   ToLocalTime(utcTimes.set, _localTimes.set);
+   ToLocalTime(utcTimes.transit, _localTimes.transit);
+   ToLocalTime(utcTimes.civilDawn, _localTimes.civilDawn);
+   ToLocalTime(utcTimes.civilDusk, _localTimes.civilDusk);
 
+   return 0;
+} // end CalcLocalTimes
@@ -1,56 +1,67 @@
 #pragma once
 
 #include <string>
-#include <chrono>
-#include <boost/coroutine2/all.hpp>
+#include <ctime>
 
 #include "CommonDef.h"
 #include "DateTimeUtils.h"
-#include "LocationReader.h"
-#include "SunriseSunsetReader.h"
+#include "SunTable.h"
+#include "TimerService.h"
 
 
 using namespace std;
-using namespace std::chrono;
-using namespace boost::coroutines2;
+
+
+// the longest timer wait, the refresh deadline is wall clock time and the
+// timers are monotonic, so a clock step (ntp at boot, a manual set) is
+// caught within this
+const unsigned SUN_RECHECK_MS = 60 * 60 * 1000;
 
 
 enum class SunriseSunsetStatus : int {
    Initial = 0,
-   CoordsStarted,
-   CoordsComplete,
-   SunRiseSetStarted,
    SunRiseSetComplete,
    WaitForNextDay,
    Error,
 };
 
-const int MAX_RETRIES = 3;
-
 
+// the sun times of today, refreshed once a day at updateAt local time by a
+// TimerService deadline, nothing runs between the refreshes
 class SunriseSunset {
 public:
-   SunriseSunset(const Address &address, const string &updateAt);
+   // the times are read from sunTable, sunTable and timers must outlive this object
+   SunriseSunset(SunTable &sunTable, TimerService &timers, const string &updateAt);
    ~SunriseSunset();
 
+   // calculate today's times now and arm the timer for the next refresh
+   int Start();
+   void Stop();
+
+   // the status, SunRiseSetComplete or Error are returned once after a
+   // refresh then it reads WaitForNextDay
+   SunriseSunsetStatus Poll();
+
    SunriseSunsetStatus GetStatus() { return _status; }
    SunTimes GetTimes() { return _localTimes; }
    string GetError() { return _errorStr; }
 
-   void FetchTimes(coroutine<SunriseSunsetStatus>::push_type& out);
-
 private:
-   Address _address;
-   Coordinates _coords;
-   SunriseSunsetStringTimes _times;
+   SunTable &_sunTable;
+   TimerService &_timers;
+   TimerHandle _timer;
    SunriseSunsetStatus _status;
    string _errorStr;
-   bool _hasCoords;
    unsigned _fetchHour;
    unsigned _fetchMinute;
+   time_t _nextRefresh;
    SunTimes _localTimes;
 
-   int Setup(const Address& address, const string& time);
-   int Convert2Local();
+   int Setup(const string& time);
+   int CalcLocalTimes();
+   void OnTimer();
+   void Refresh(time_t now);
+   int Arm(time_t now);
+   time_t NextRefresh(time_t now);
 
 }; // end class
@@ -0,0 +1,202 @@
+#include "TimerService.h"
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <ctime>
+
+
+TimerService::TimerService() {
+   _fd = -1;
+   _armedNs = 0;
+} // end ctor
+
+
+TimerService::~TimerService() {
+   Close();
+} // end dtor
+
+
+int TimerService::Open() {
+
+   if(_fd >= 0) return 0;
+
+   _fd = timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK | TFD_CLOEXEC);
+   if(_fd < 0) {
+      _errorStr = string("timerfd_create() failed: ") + strerror(errno);
+      return -1;
+   } // end if
+
+   _armedNs = 0;
+   return 0;
+} // end Open
+
+
+void TimerService::Close() {
+
+   if(_fd >= 0) close(_fd);
+   _fd = -1;
+   _armedNs = 0;
+
+} // end Close
+
+
+TimerHandle TimerService::Create(const string &name, Callback callback) {
+   Slot slot;
+   slot.name = name;
+   slot.callback = callback;
+   slot.generation = 0;
+   slot.running = false;
+   slot.done = false;
+
+   _slots.push_back(slot);
+   return static_cast<TimerHandle>(_slots.size() - 1);
+} // end Create
+
+
+int TimerService::Start(TimerHandle handle, unsigned ms) {
+
+   if(handle >= _slots.size()) {
+      _errorStr = "invalid timer handle";
+      return -1;
+   } // end if
+
+   // a new generation makes any earlier heap entry for the slot stale
+   Slot &slot = _slots[handle];
+   ++slot.generation;
+   slot.running = true;
+   slot.done = false;
+
+   _heap.push_back(Deadline{NowNs() + static_cast<int64_t>(ms) * 1000000, handle, slot.generation});
+   push_heap(_heap.begin(), _heap.end(), LaterDeadline);
+
+   Compact();
+   return Arm();
+} // end Start
+
+
+void TimerService::Cancel(TimerHandle handle) {
+
+   if(handle >= _slots.size()) return;
+
+   // the heap entry stays until it reaches the top, the timerfd may
+   // still fire for it and Dispatch() just finds nothing to do
+   Slot &slot = _slots[handle];
+   ++slot.generation;
+   slot.running = false;
+   slot.done = false;
+
+} // end Cancel
+
+
+bool TimerService::IsRunning(TimerHandle handle) {
+   return handle < _slots.size() && _slots[handle].running;
+} // end IsRunning
+
+
+bool TimerService::IsDone(TimerHandle handle) {
+
+   if(handle >= _slots.size()) return false;
+
+   bool ret = _slots[handle].done;
+   _slots[handle].done = false;
+   return ret;
+} // end IsDone
+
+
+int TimerService::Dispatch() {
+   int fired = 0;
+
+   // clear the expiration count so the fd stops being readable,
+   // nothing to read (EAGAIN) means the timerfd is still armed
+   if(_fd >= 0) {
+      uint64_t expirations = 0;
+      if(read(_fd, &expirations, sizeof(expirations)) == sizeof(expirations)) {
+         _armedNs = 0;
+      } // end if
+   } // end if
+
+   int64_t now = NowNs();
+
+   while(_heap.empty() == false && _heap.front().ns <= now) {
+      Deadline top = _heap.front();
+      pop_heap(_heap.begin(), _heap.end(), LaterDeadline);
+      _heap.pop_back();
+
+      if(IsStale(top) == true) continue;
+
+      Slot &slot = _slots[top.handle];
+      slot.running = false;
+      slot.done = true;
+      ++fired;
+
+      // the callback may Start() the timer again, that pushes a new entry
+      if(slot.callback) slot.callback();
+   } // end while
+
+   if(Arm() != 0) return -1;
+
+   return fired;
+} // end Dispatch
+
+
+bool TimerService::IsStale(const Deadline &deadline) {
+   const Slot &slot = _slots[deadline.handle];
+   return slot.running == false || slot.generation != deadline.generation;
+} // end IsStale
+
+
+// drop the cancelled entries once they outnumber the live timers,
+// keeps the heap bounded when timers are restarted far ahead of expiring
+void TimerService::Compact() {
+
+   if(_heap.size() <= 2 * _slots.size() + 16) return;
+
+   _heap.erase(remove_if(_heap.begin(), _heap.end(),
+                         [this](const Deadline &d) { return IsStale(d); }), _heap.end());
+   make_heap(_heap.begin(), _heap.end(), LaterDeadline);
+
+} // end Compact
+
+
+// arm the timerfd for the earliest live deadline, disarm if none
+int TimerService::Arm() {
+
+   if(_fd < 0) return 0;
+
+   while(_heap.empty() == false && IsStale(_heap.front()) == true) {
+      pop_heap(_heap.begin(), _heap.end(), LaterDeadline);
+      _heap.pop_back();
+   } // end while
+
+   int64_t next = (_heap.empty() == true ? 0 : _heap.front().ns);
+   if(next == _armedNs) return 0;
+
+   // absolute time so the deadline doesn't drift with the call time,
+   // a zero it_value disarms
+   itimerspec its{};
+   if(next > 0) {
+      its.it_value.tv_sec = static_cast<time_t>(next / 1000000000);
+      its.it_value.tv_nsec = static_cast<long>(next % 1000000000);
+   } // end if
+
+   if(timerfd_settime(_fd, TFD_TIMER_ABSTIME, &its, nullptr) < 0) {
+      _errorStr = string("timerfd_settime() failed: ") + strerror(errno);
+      return -1;
+   } // end if
+
+   _armedNs = next;
+   return 0;
+} // end Arm
+
+
+// min-heap on the deadline for the std heap functions
+bool TimerService::LaterDeadline(const Deadline &a, const Deadline &b) {
+   return a.ns > b.ns;
+} // end LaterDeadline
+
+
+int64_t TimerService::NowNs() {
+   timespec ts;
+   clock_gettime(CLOCK_MONOTONIC, &ts);
+   return static_cast<int64_t>(ts.tv_sec) * 1000000000 + ts.tv_nsec;
+} // end NowNs
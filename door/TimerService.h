@@ -0,0 +1,101 @@
+/// file: TimerService.h header for TimerService class
+/// author: Bennett Cook
+/// date: 10-17-2026
+/// description: one timerfd for all the program timers. Each named timer
+/// is a slot created once, Start() pushes its deadline on a min-heap and
+/// arms the timerfd for the earliest one. Cancel() only bumps the slot
+/// generation, so it is O(1) and never blocks, the stale heap entry is
+/// skipped when it reaches the top. No threads, Dispatch() runs on the
+/// main loop thread when the fd is readable (or on every loop pass).
+
+
+// header guard
+#ifndef TIMERSERVICE_H
+#define TIMERSERVICE_H
+
+#include <unistd.h>
+#include <sys/timerfd.h>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <functional>
+#include <boost/core/noncopyable.hpp>
+
+using namespace std;
+
+
+// index of a timer slot made by TimerService::Create()
+using TimerHandle = unsigned;
+const TimerHandle INVALID_TIMER_HANDLE = ~0u;
+
+
+class TimerService : private boost::noncopyable {
+public:
+
+   // runs on the Dispatch() thread when the timer expires
+   using Callback = std::function<void()>;
+
+   TimerService();
+   ~TimerService();
+
+   int Open();
+   void Close();
+
+   // readable when a deadline has passed, watch with EPOLLIN
+   int GetFd() { return _fd; }
+
+   // make a named timer slot, done once at startup
+   TimerHandle Create(const string &name, Callback callback = nullptr);
+
+   // one shot, restarts the timer if it is running
+   int Start(TimerHandle handle, unsigned ms);
+
+   // O(1), also clears a done timer that was not read yet
+   void Cancel(TimerHandle handle);
+
+   bool IsRunning(TimerHandle handle);
+
+   // true once after the timer expired, like the old NoBlockTimer::IsDone()
+   bool IsDone(TimerHandle handle);
+
+   const string &GetName(TimerHandle handle) { return _slots[handle].name; }
+
+   // fire every expired timer and re-arm the timerfd,
+   // return the number of timers that expired, -1 on error
+   int Dispatch();
+
+   string GetErrorStr() { return _errorStr; }
+
+private:
+
+   struct Slot {
+      string name;
+      Callback callback;
+      uint32_t generation;
+      bool running;
+      bool done;
+   }; // end struct
+
+   // heap entry, generation must match the slot or the entry is stale
+   struct Deadline {
+      int64_t ns;
+      TimerHandle handle;
+      uint32_t generation;
+   }; // end struct
+
+   int _fd;
+   vector<Slot> _slots;
+   vector<Deadline> _heap;
+   int64_t _armedNs;
+   string _errorStr;
+
+   bool IsStale(const Deadline &deadline);
+   void Compact();
+   int Arm();
+   static bool LaterDeadline(const Deadline &a, const Deadline &b);
+   static int64_t NowNs();
+
+}; // end class
+
+
+#endif // end header guard
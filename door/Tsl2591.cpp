@@ -2,17 +2,21 @@
 // BCook 5/2/2022, adapted from Adafruit Tsl2591 c++ code on github 
 
 #include "Tsl2591.h"
-#include <cassert>
 
 
 Tsl2591::Tsl2591() : I2C(TSL2591_I2C_ADDRESS) {
    _lightLevel = 0;
-   _gain = static_cast<float>(TSL2591_GAIN_MID);
-   _integration = static_cast<float>(TSL2591_READ_TIME_300MS);
+   _quality = LuxQuality::Valid;
+   _range = TSL2591_RANGE_START;
+   _gain = GAIN_VALUES.at(TSL2591_RANGES[_range].gain);
+   _integration = READ_TIME_VALUES.at(TSL2591_RANGES[_range].integration);
+   _enabled = false;
 } // end ctor 
 
 
 Tsl2591::~Tsl2591(){
+   // leave the chip powered down
+   if(_enabled == true) Disable();
 } // end dtor 
 
 int Tsl2591::PowerOn(bool on){
@@ -21,9 +25,8 @@ int Tsl2591::PowerOn(bool on){
    unsigned char state = (on == true ? (TSL2591_POWERON | TSL2591_ENABLE_AEN) : TSL2591_POWEROFF);
    unsigned char command[2] = {TSL2591_COMMAND_BITS | TSL2591_REGISTER_ENABLE, state}; 
    // cout << "PowerOn: " << static_cast<unsigned short>(command[0]) << " " << static_cast<unsigned short>(command[1]) << endl;
-   if(write(_fd, command, 2) != 2){
+   if(WriteBytes(command, 2, "error on setting power state") != 0){
       ret = -1;
-      _error = "error on setting power state";
    } // end if 
 
    return ret;
@@ -34,22 +37,14 @@ int Tsl2591::ReadDeviceId(){
    int ret = 0;
    _id = 0;
 
+   // the register write and the read in one transaction
    unsigned char command = TSL2591_COMMAND_BITS | TSL2591_REGISTER_ID;  
-   if(write(_fd, &command, 1) == 1){
-            
-      unsigned char data[1] = {0};
-      if(read(_fd, data, 1) == 1){
-         _id = data[0];
-      }
-      else {
-         ret = -1;
-         _error = "read id error";
-	   } // end if
-      
+   unsigned char data[1] = {0};
+   if(WriteRead(&command, 1, data, 1, "read id error") == 0){
+      _id = data[0];
    }
    else {
       ret = -1;
-      _error = "error on request id";
    } // end if 
 
    return ret;
@@ -61,21 +56,12 @@ int Tsl2591::ReadDeviceStatus(){
    _status = 0;
 
    unsigned char command = TSL2591_COMMAND_BITS | TSL2591_REGISTER_STATUS;  
-   if(write(_fd, &command, 1) == 1){
-            
-      unsigned char data[1] = {0};
-      if(read(_fd, data, 1) == 1){
-         _status = data[0];
-      }
-      else {
-         ret = -1;
-         _error = "read status error";
-	   } // end if
-      
+   unsigned char data[1] = {0};
+   if(WriteRead(&command, 1, data, 1, "read status error") == 0){
+      _status = data[0];
    }
    else {
       ret = -1;
-      _error = "error on request status";
    } // end if 
 
    return ret;
@@ -85,44 +71,34 @@ int Tsl2591::ReadDeviceStatus(){
 int Tsl2591::SetIntegrationAndGain(unsigned char gain, unsigned char integration){
    int ret = 0;
    
-   _gain = static_cast<float>(gain);
-   _integration = static_cast<float>(integration);
+   // the lux needs the multiplier and the ms, not the register bits
+   _gain = GAIN_VALUES.at(gain);
+   _integration = READ_TIME_VALUES.at(integration);
 
    unsigned char command[2]; 
    command[0] = TSL2591_COMMAND_BITS | TSL2591_REGISTER_CONTROL; 
    command[1] = gain | integration; 
 
-   if(write(_fd, command, 2) != 2){
+   if(WriteBytes(command, 2, "error on set integration and gain") != 0){
       ret = -1;
-      _error = "error on set integration and gain";
    } // end if 
    
    return ret;
 } // end SetIntegrationAndGain
 
 
+// the 4 channel bytes in one block read, the command auto increments the
+// register from CH0_LO, reading CH0_LO latches the others
 int Tsl2591::ReadLightLevels() {
-   int ret = 0;
-   int result = 0;
-   
-   unsigned char v1 = 0;
-   unsigned char v2 = 0;
-
-   result = ReadRegister(TSL2591_REGISTER_CH0_LO, v1);
-   assert(result == 0);
-
-   result = ReadRegister(TSL2591_REGISTER_CH0_HI, v2);
-   assert(result == 0);
-
-   unsigned short ch0 = (static_cast<unsigned short>(v2) << 8) | static_cast<unsigned short>(v1);
 
-   result = ReadRegister(TSL2591_REGISTER_CH1_LO, v1);
-   assert(result == 0);
-
-   result = ReadRegister(TSL2591_REGISTER_CH1_HI, v2);
-   assert(result == 0);
+   unsigned char command = TSL2591_COMMAND_BITS | TSL2591_REGISTER_CH0_LO;
+   unsigned char data[4] = {0};
+   if(WriteRead(&command, 1, data, 4, "read channels error") != 0) {
+      return -1;
+   } // end if 
 
-   unsigned short ch1 = (static_cast<unsigned short>(v2) << 8) | static_cast<unsigned short>(v1);
+   unsigned short ch0 = (static_cast<unsigned short>(data[1]) << 8) | static_cast<unsigned short>(data[0]);
+   unsigned short ch1 = (static_cast<unsigned short>(data[3]) << 8) | static_cast<unsigned short>(data[2]);
 
    // combine channels into a raw light value
    _rawLightLevel = (static_cast<unsigned>(ch1) << 16) | ch0; 
@@ -130,20 +106,79 @@ int Tsl2591::ReadLightLevels() {
    // calc the lux value from the two different sensors
    _lightLevel = CalculateLux(ch0, ch1);
 
-   return ret;
+   if(ch0 >= MaxCount() || ch1 >= MaxCount()) {
+      _quality = LuxQuality::Saturated;
+   }
+   else if(ch0 < TSL2591_LOW_COUNTS) {
+      _quality = LuxQuality::LowCounts;
+   }
+   else {
+      _quality = LuxQuality::Valid;
+   } // end if 
+
+   return 0;
 } // end ReadLightLevels
 
 
+unsigned Tsl2591::MaxCount() {
+   return TSL2591_RANGES[_range].integration == TSL2591_READ_TIME_100MS ? TSL2591_MAX_COUNT_100MS : TSL2591_MAX_COUNT;
+} // end MaxCount
+
+
+// the range for the next read. Near full scale one step down, saturated
+// the counts are unknown so TSL2591_RANGE_SATURATED_STEPS down and the
+// next read steps up again if that was too far. Up as far as the counts
+// would stay under the hysteresis
+size_t Tsl2591::NextRange(unsigned ch0, unsigned ch1) {
+   unsigned counts = ch0 > ch1 ? ch0 : ch1;
+   float high = TSL2591_RANGE_HIGH * static_cast<float>(MaxCount());
+
+   if(counts >= MaxCount()) 
+      return _range > TSL2591_RANGE_SATURATED_STEPS ? _range - TSL2591_RANGE_SATURATED_STEPS : 0;
+
+   if(static_cast<float>(counts) > high) 
+      return _range > 0 ? _range - 1 : 0;
+
+   size_t next = _range;
+   float sensitivity = _gain * _integration;
+
+   while(next + 1 < TSL2591_RANGE_COUNT) {
+      const Tsl2591Range &up = TSL2591_RANGES[next + 1];
+      float upSensitivity = GAIN_VALUES.at(up.gain) * READ_TIME_VALUES.at(up.integration);
+      float upMax = up.integration == TSL2591_READ_TIME_100MS ? TSL2591_MAX_COUNT_100MS : TSL2591_MAX_COUNT;
+
+      if(static_cast<float>(counts) * upSensitivity / sensitivity > TSL2591_RANGE_HYSTERESIS * TSL2591_RANGE_HIGH * upMax) break;
+      ++next;
+   } // end while
+
+   return next;
+} // end NextRange
+
+
+// new gain and integration, the als is restarted so AVALID waits for an
+// integration with the new setting
+int Tsl2591::SetRange(size_t range) {
+
+   _range = range;
+   if(SetIntegrationAndGain(TSL2591_RANGES[range].gain, TSL2591_RANGES[range].integration) != 0) return -1;
+
+   unsigned char command[2] = {TSL2591_COMMAND_BITS | TSL2591_REGISTER_ENABLE, TSL2591_POWERON}; 
+   if(WriteBytes(command, 2, "error on als restart") != 0) return -1;
+
+   return PowerOn(true);
+} // end SetRange
+
+
 float Tsl2591::CalculateLux(unsigned ch0, unsigned ch1){
    float ret = 0;
 
    // check for saturation
-   if(ch0 == 0xffff || ch1 == 0xffff){
+   if(ch0 >= MaxCount() || ch1 >= MaxCount()){
       return MAX_LUX_VALUE;
    }  // end if 
 
-   // check for zero
-   if(ch0 == 0x0 || ch1 == 0x0){
+   // check for zero, ch1 (ir) can be 0 with some visible light
+   if(ch0 == 0x0){
       return MIN_LUX_VALUE;
    }  // end if 
 
@@ -161,33 +196,52 @@ float Tsl2591::CalculateLux(unsigned ch0, unsigned ch1){
 } // end CalculateLux
 
 
-// read an 8bit register 
-int Tsl2591::ReadRegister(unsigned char regNum, unsigned char &val){
-   int ret = 0;
+// power on with the als enabled, the chip then integrates continuously
+int Tsl2591::Enable(){
 
-   unsigned char command[1];
-   command[0] = TSL2591_COMMAND_BITS | regNum; 
-   // cout << "ReadRegister: " << static_cast<unsigned short>(command[0]) << endl;
-   if(write(_fd, &command, 1) == 1){
-            
-      unsigned char data[1] = {0};
-      if(read(_fd, data, 1) == 1){
-         val = data[0];
-         // cout << "data: " << static_cast<unsigned short>(data[0]) << endl;
-      }
-      else {
-         ret = -1;
-         _error = "read data error";
-	   } // end if
-      
-   }
-   else {
-      ret = -1;
-      _error = "error on read data request";
-   } // end if 
+   const Tsl2591Range &range = TSL2591_RANGES[_range];
+   int result = SetIntegrationAndGain(range.gain, range.integration);
+   if(result == 0) 
+      result = PowerOn(true);
+
+   _enabled = (result == 0);
+   return result;
+} // end Enable
 
-   return ret;
-} // end ReadRegister
+
+// best effort, keeps the error of the read that failed
+void Tsl2591::Disable(){
+   string error = _error;
+
+   _enabled = false;
+   PowerOn(false);
+   _error = error;
+} // end Disable
+
+
+// poll the status until AVALID, an integration completed since the
+// enable. In continuous mode it stays set so this is one read after
+// the first sample
+int Tsl2591::WaitForValid(){
+
+   // the integration time plus the same again for one that just started
+   int waitedMs = 0;
+   int timeoutMs = 2 * static_cast<int>(_integration);
+
+   while(true) {
+      if(ReadDeviceStatus() != 0) return -1;
+      if((_status & TSL2591_VALID_READ_STATUS) == TSL2591_VALID_READ_STATUS) return 0;
+
+      if(waitedMs >= timeoutMs) {
+         _error = "sensor didn't complete the read channels";
+         return -1;
+      } // end if 
+
+      this_thread::sleep_for(chrono::milliseconds(TSL2591_POLL_MS));
+      waitedMs += TSL2591_POLL_MS;
+   } // end while
+
+} // end WaitForValid
 
 
 string Tsl2591::LightLevelToString(){
@@ -201,81 +255,40 @@ string Tsl2591::LightLevelToString(){
 } // end LightLevelToString
 
 
+// continuous mode, the first read enables the als and waits one
+// integration, the later reads are a status read and a block read.
+// A read out of range changes the range and reads again, up to
+// TSL2591_RANGE_TRIES times, so a saturated read isn't reported when a
+// less sensitive range can measure it.
+// An error powers the chip down so the next read starts over
 int Tsl2591::ReadSensor(){
-   int ret = 0;
 
    _lightLevel = 0;
    _error = "";
 
-   int result = Open();
-   if(result == 0) {
+   if(Open() != 0) return -1;
 
-      result = PowerOn(true);
-      if(result != 0) {
-         Close();
-         return -1;
-      } // end if 
-
-      result = SetIntegrationAndGain(TSL2591_GAIN_MID, TSL2591_READ_TIME_300MS);
-      if(result != 0) {
-         PowerOn(false);
-         Close();
-         return -1;
-      } // end if 
+   if(_enabled == false && Enable() != 0) {
+      Disable();
+      return -1;
+   } // end if 
 
-      result = PowerOn(false);
-      if(result != 0) {
-         Close();
-         return -1;
-      } // end if 
- 
-      this_thread::sleep_for(chrono::milliseconds(100ms));
+   for(int tries = 0; ; ++tries) {
 
-      result = PowerOn(true);
-      if(result != 0) {
-         Close();
+      if(WaitForValid() != 0 || ReadLightLevels() != 0) {
+         Disable();
          return -1;
       } // end if 
 
-      this_thread::sleep_for(chrono::milliseconds(1200ms));
+      size_t next = NextRange(_rawLightLevel & 0xffff, _rawLightLevel >> 16);
+      if(next == _range || tries == TSL2591_RANGE_TRIES) break;
 
-      result = ReadLightLevels();
-      if(result != 0) {
-         PowerOn(false);
-         Close();
+      if(SetRange(next) != 0) {
+         Disable();
          return -1;
       } // end if 
+   } // end for
 
-      // this status is from the sensor internally,
-      unsigned char status = 0;   // 0 = not a valid read
-      result = ReadDeviceStatus();
-      if(result == 0) {
-
-         // look at lowest bit only, a good read == 1
-         status = (GetDeviceStatus()  & 0x01);
-      }
-      else {
-         ret = -1;
-      } // end if 
-      
-      result = PowerOn(false);
-      if(result != 0) {
-         ret = -1;
-      } // end if 
-
-      Close();
-
-      // report the sensor status 
-      if(status != TSL2591_VALID_READ_STATUS){
-         _error = "sensor didn't complete the read channels";
-         ret = -1;
-      } // end if 
-
-   } 
-   else {
-      ret = -1;
-   } // end if 
-
-   return ret;
+   return 0;
 } // end ReadSensor
 
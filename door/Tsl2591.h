@@ -56,6 +56,13 @@ const unsigned char TSL2591_READ_TIME_400MS = 0x03;  // 400 ms
 const unsigned char TSL2591_READ_TIME_500MS = 0x04;  // 500 ms
 const unsigned char TSL2591_READ_TIME_600MS = 0x05;  // 600 ms
 
+// status poll period while waiting for AVALID
+const int TSL2591_POLL_MS = 10;
+
+// adc full scale, a 100 ms integration tops out below 16 bits
+const unsigned TSL2591_MAX_COUNT_100MS = 36863;
+const unsigned TSL2591_MAX_COUNT = 65535;
+
 // interrupt not used in this app  
 const unsigned char TSL2591_CLEAR_INT = 0xE7;
 
@@ -97,14 +104,68 @@ const map<unsigned char, float> READ_TIME_VALUES = {
 }; // end read time (integration) map definition
 
 
+// auto range, the gain and integration pairs from the least to the most
+// sensitive, each step is 2x to 8x the one before
+struct Tsl2591Range {
+   unsigned char gain;
+   unsigned char integration;
+}; // end struct
+
+const Tsl2591Range TSL2591_RANGES[] = {
+   {TSL2591_GAIN_LOW, TSL2591_READ_TIME_100MS},    // 100
+   {TSL2591_GAIN_LOW, TSL2591_READ_TIME_300MS},    // 300
+   {TSL2591_GAIN_LOW, TSL2591_READ_TIME_600MS},    // 600
+   {TSL2591_GAIN_MID, TSL2591_READ_TIME_100MS},    // 2500
+   {TSL2591_GAIN_MID, TSL2591_READ_TIME_300MS},    // 7500
+   {TSL2591_GAIN_MID, TSL2591_READ_TIME_600MS},    // 15000
+   {TSL2591_GAIN_HIGH, TSL2591_READ_TIME_200MS},   // 85600
+   {TSL2591_GAIN_HIGH, TSL2591_READ_TIME_600MS},   // 256800
+   {TSL2591_GAIN_MAX, TSL2591_READ_TIME_200MS},    // 1975200
+   {TSL2591_GAIN_MAX, TSL2591_READ_TIME_600MS},    // 5925600
+}; // end ranges
+
+const size_t TSL2591_RANGE_COUNT = sizeof(TSL2591_RANGES) / sizeof(TSL2591_RANGES[0]);
+
+// mid gain 300 ms, the fixed setting before auto range
+const size_t TSL2591_RANGE_START = 4;
+
+// a count above this fraction of full scale steps down, a step up must
+// land below HYSTERESIS of it so the next read doesn't step back
+const float TSL2591_RANGE_HIGH = 0.8f;
+const float TSL2591_RANGE_HYSTERESIS = 0.7f;
+
+// steps down from a saturated read, about 25x to 60x less sensitive
+const size_t TSL2591_RANGE_SATURATED_STEPS = 3;
+
+// range changes in one ReadSensor() before the read is reported as is
+const int TSL2591_RANGE_TRIES = 3;
+
+// fewer counts at the most sensitive range are only an estimate
+const unsigned TSL2591_LOW_COUNTS = 100;
+
+
+// how far to trust the lux of a read
+enum class LuxQuality : int {
+   Valid = 0,
+   LowCounts,     // few counts, the lux is an estimate (dark at the most sensitive range)
+   Saturated      // a channel at full scale, the lux is MAX_LUX_VALUE
+}; // end enum
+
+
 class Tsl2591 : public I2C {
 public:
    Tsl2591();
    ~Tsl2591();
 
+   // continuous als mode, the chip stays powered between reads, the
+   // gain and integration follow the light
    int ReadSensor();
 
    float GetLightLevel() {return _lightLevel;}
+   LuxQuality GetQuality() {return _quality;}
+   size_t GetRange() {return _range;}
+   float GetGain() {return _gain;}
+   float GetIntegrationMs() {return _integration;}
    unsigned GetRawLightLevel() {return _rawLightLevel;}
    unsigned char GetDeviceStatus() {return _status;}
    unsigned char GetDeviceId() {return _id;}
@@ -113,19 +174,27 @@ public:
 private:
 
    int PowerOn(bool on);
+   int Enable();
+   void Disable();
+   int WaitForValid();
    int ReadDeviceId();
    int ReadDeviceStatus();
    int SetIntegrationAndGain(unsigned char gain, unsigned char integration);
+   int SetRange(size_t range);
+   size_t NextRange(unsigned ch0, unsigned ch1);
+   unsigned MaxCount();
    int ReadLightLevels();
-   int ReadRegister(unsigned char regNum, unsigned char &val);
    float CalculateLux(unsigned ch0, unsigned ch1);
 
    unsigned _rawLightLevel;
    float _lightLevel;
-   float _gain;
-   float _integration;
+   LuxQuality _quality;
+   size_t _range;
+   float _gain;            // multiplier, 1 to 9876
+   float _integration;     // ms
    unsigned char _status;
    unsigned char _id;
+   bool _enabled;
 
 }; // end class
 
@@ -1,11 +1,15 @@
 #include "Tsl2591Reader.h"
+#include "Logger.h"
 
 
 Tsl2591Reader::Tsl2591Reader() {
+   _range = _sensor.GetRange();
 } // end ctor 
 
 
 Tsl2591Reader::~Tsl2591Reader() {
+   // RunTask() may be running on the reader pool
+   CancelRead();
 } // end dtor 
 
 
@@ -16,9 +20,15 @@ int Tsl2591Reader::RunTask() {
    if(result == 0) {
 
       _sensorData.lightLevel = _sensor.GetLightLevel();
+      _sensorData.quality = _sensor.GetQuality();
       _sensorData.rawlightLevel = _sensor.GetRawLightLevel(); 
       _sensorData.lightLevelStr = _sensor.LightLevelToString();
 
+      if(_sensor.GetRange() != _range) {
+         _range = _sensor.GetRange();
+         Log(LogLevel::Info, LogEvent::LightRange, _range, _sensor.GetGain(), _sensor.GetIntegrationMs());
+      } // end if 
+
       // required call to parent 
       Reader::SetStatus(ReaderStatus::Complete, "no error");
    }
@@ -20,6 +20,7 @@ using namespace std;
 // data from the sensor 
 struct Tsl2591Data {
    float lightLevel;
+   LuxQuality quality;     // Saturated or LowCounts, the lux is at a limit
    string lightLevelStr;
    unsigned short rawlightLevel;
 }; // end struct
@@ -36,6 +37,7 @@ private:
 
    Tsl2591 _sensor;
    Tsl2591Data _sensorData;
+   size_t _range;
 
 }; // end class 
 
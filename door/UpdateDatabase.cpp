@@ -1,19 +1,29 @@
-
 #include "UpdateDatabase.h"
 
 
 UpdateDatabase::UpdateDatabase(){
    _errorStr = "success";
+   _synchronous = "NORMAL";
+   _rawRetentionDays = 0;
+   _fiveMinRetentionDays = 0;
    _db = nullptr;
-} // end ctor 
+   _doorStateStmt = nullptr;
+   _sensorDataStmt = nullptr;
+   _sunDataStmt = nullptr;
+} // end ctor
 
 
 UpdateDatabase::~UpdateDatabase() {
-} // end dtor 
+   Close();
+} // end dtor
 
 
 int UpdateDatabase::SetDbFullPath(const string &fullPath) {
     int ret = 0;
+
+    // a new file needs a new connection
+    if(fullPath != _dbFullPath) Close();
+
     _dbFullPath = fullPath;
     return ret;
   } // end SetDbFilename
@@ -21,6 +31,10 @@ int UpdateDatabase::SetDbFullPath(const string &fullPath) {
 
 int UpdateDatabase::SetDoorStateTableName(const string &dbDoorStateTable) {
    int ret = 0;
+
+   // the table name is part of the prepared sql, prepare again on next Open()
+   if(dbDoorStateTable != _dbDoorStateTable) Close();
+
    _dbDoorStateTable = dbDoorStateTable;
    return ret;
 } // end SetDoorStateTableName
@@ -28,6 +42,9 @@ int UpdateDatabase::SetDoorStateTableName(const string &dbDoorStateTable) {
 
 int UpdateDatabase::SetSensorDataTableName(const string &dbSensorDataTable){
    int ret = 0;
+
+   if(dbSensorDataTable != _dbSensorDataTable) Close();
+
    _dbSensorDataTable = dbSensorDataTable;
    return ret;
 } // end SetSensorDataTableName
@@ -35,304 +52,692 @@ int UpdateDatabase::SetSensorDataTableName(const string &dbSensorDataTable){
 
 int UpdateDatabase::SetSunDataTableName(const string &dbSunDataTable){
    int ret = 0;
+
+   if(dbSunDataTable != _dbSunDataTable) Close();
+
    _dbSunDataTable = dbSunDataTable;
    return ret;
 } // end SetSunDataTableName
 
 
-int UpdateDatabase::OpenAndBeginDB(){
-   int ret = 0;
-   char *zErrMsg = 0;
+int UpdateDatabase::SetSynchronous(const string &level){
 
-    // open db use full path 
-   int rc = sqlite3_open(_dbFullPath.c_str(), &_db);
-   if(!rc) {
-
-      // execute sql statement 
-      rc = sqlite3_exec(_db, "begin", callback, 0, &zErrMsg);
-      if( rc != SQLITE_OK ){
-         _errorStr = "begin command error: ";
-         _errorStr += sqlite3_errmsg(_db);
-         sqlite3_free(zErrMsg);
-         sqlite3_close(_db);
-         ret = -1;
-      } // end if
+   string upper = boost::to_upper_copy(level);
+   if(upper != "OFF" && upper != "NORMAL" && upper != "FULL" && upper != "EXTRA") {
+      _errorStr = "synchronous level must be OFF, NORMAL, FULL or EXTRA: " + level;
+      return -1;
+   } // end if
 
-   }
-   else {
+   // pragma synchronous is per connection, apply on the next Open()
+   if(upper != _synchronous) Close();
+
+   _synchronous = upper;
+   return 0;
+} // end SetSynchronous
+
+
+int UpdateDatabase::SetRetention(int rawDays, int fiveMinDays){
+
+   if(rawDays < 0 || fiveMinDays < 0) {
+      _errorStr = "retention days can't be negative";
+      return -1;
+   } // end if
+
+   _rawRetentionDays = rawDays;
+   _fiveMinRetentionDays = fiveMinDays;
+   return 0;
+} // end SetRetention
+
+
+int UpdateDatabase::Open(){
+
+   // already open, nothing to do
+   if(_db != nullptr) return 0;
+
+    // open db use full path
+   int rc = sqlite3_open(_dbFullPath.c_str(), &_db);
+   if(rc != SQLITE_OK) {
       _errorStr = "can't open database: ";
       _errorStr += sqlite3_errmsg(_db);
-      sqlite3_free(zErrMsg);
-      ret = -1;
-   } // end if 
+      sqlite3_close(_db);
+      _db = nullptr;
+      return -1;
+   } // end if
 
-  
-   return ret;
-} // end OpenAndBegin
+   // the tables and indexes must be current before the inserts are prepared
+   if(ConfigureConnection() != 0 || Migrate() != 0) {
+      Close();
+      return -1;
+   } // end if
 
+   // prepare the inserts once, only the values change per row
+   string sql = "insert into " + QuoteIdentifier(_dbDoorStateTable) +
+                " (timestamp, state, light, pi_temp, decision) values (?, ?, ?, ?, ?)";
+   if(Prepare(sql, &_doorStateStmt) != 0) {
+      Close();
+      return -1;
+   } // end if
 
-int UpdateDatabase::CommitAndCloseDB(){
-   int ret = 0;
-   char *zErrMsg = 0;
+   sql = "insert into " + QuoteIdentifier(_dbSensorDataTable) +
+         " (timestamp, temperature, humidity, light) values (?, ?, ?, ?)";
+   if(Prepare(sql, &_sensorDataStmt) != 0) {
+      Close();
+      return -1;
+   } // end if
 
-     // execute end (commit) transition 
-   int rc = sqlite3_exec(_db, "end", callback, 0, &zErrMsg);
-   if( rc != SQLITE_OK ){
-      _errorStr = "begin command error: ";
-      _errorStr += sqlite3_errmsg(_db);
-      sqlite3_free(zErrMsg);
-      ret = -1;
-   } // end if 
-   
+   sql = "insert into " + QuoteIdentifier(_dbSunDataTable) +
+         " (timestamp, sunrise, sunset) values (?, ?, ?)";
+   if(Prepare(sql, &_sunDataStmt) != 0) {
+      Close();
+      return -1;
+   } // end if
+
+   return 0;
+} // end Open
+
+
+void UpdateDatabase::Close(){
+
+   if(_db == nullptr) return;
+
+   FinalizeStatements();
    sqlite3_close(_db);
    _db = nullptr;
- 
+
+} // end Close
+
+
+int UpdateDatabase::BeginTransaction(){
+
+   if(Open() != 0) return -1;
+
+   return ExecSql("begin", "begin command error: ");
+} // end BeginTransaction
+
+
+int UpdateDatabase::CommitTransaction(){
+
+   if(_db == nullptr) {
+      _errorStr = "commit command error: database not open";
+      return -1;
+   } // end if
+
+   return ExecSql("end", "commit command error: ");
+} // end CommitTransaction
+
+
+int UpdateDatabase::RollbackTransaction(){
+
+   if(_db == nullptr) {
+      _errorStr = "rollback command error: database not open";
+      return -1;
+   } // end if
+
+   return ExecSql("rollback", "rollback command error: ");
+} // end RollbackTransaction
+
+
+int UpdateDatabase::OpenAndBeginDB(){
+   return BeginTransaction();
+} // end OpenAndBegin
+
+
+int UpdateDatabase::CommitAndCloseDB(){
+   int ret = CommitTransaction();
+   Close();
    return ret;
 } // end CommitAndCloseDB
 
 
-int UpdateDatabase::AddDoorStateRow(const string &timestamp, 
-                                    int state, 
+int UpdateDatabase::AddDoorStateRow(const string &timestamp,
+                                    int state,
                                     const string &light,
                                     const string &temperature,
                                     const string &decision) {
-   int ret = 0;
-   char *zErrMsg = 0;
 
-   // build a insert sql command 
-   string sql = "insert into" + _dbDoorStateTable + "(timestamp, state, light, pi_temp, decision) values ";
-   sql += "('" + timestamp  + "', " + lexical_cast<string>(state) + ", '" + light  + ", '" +  temperature + "', '" + decision + "')";
+   if(Open() != 0) return -1;
 
-   // execute sql statement to insert a row
-   int rc = sqlite3_exec(_db, sql.c_str(), callback, 0, &zErrMsg);
-   if( rc != SQLITE_OK ){
-      _errorStr = "insert row: ";
+   if(BindText(_doorStateStmt, 1, timestamp) != 0 ||
+      sqlite3_bind_int(_doorStateStmt, 2, state) != SQLITE_OK ||
+      BindText(_doorStateStmt, 3, light) != 0 ||
+      BindText(_doorStateStmt, 4, temperature) != 0 ||
+      BindText(_doorStateStmt, 5, decision) != 0) {
+      _errorStr = "bind door state row: ";
       _errorStr += sqlite3_errmsg(_db);
-      sqlite3_free(zErrMsg);
-      sqlite3_close(_db);
-      ret = -1;
-   } // end if 
+      sqlite3_reset(_doorStateStmt);
+      return -1;
+   } // end if
 
-   return ret;
+   return StepInsert(_doorStateStmt);
 } // end AddDoorStateRow
 
 
-int UpdateDatabase::AddOneDoorStateRow(const string &timestamp, 
-                                       int state, 
+int UpdateDatabase::AddOneDoorStateRow(const string &timestamp,
+                                       int state,
                                        const string &light,
                                        const string &temperature,
                                        const string &decision) {
-   int ret = 0;
-   char *zErrMsg = 0;
 
-   // open db use full path 
-   int rc = sqlite3_open(_dbFullPath.c_str(), &_db);
-   if(rc) {
-      _errorStr = "can't open database: ";
-      _errorStr += sqlite3_errmsg(_db);
-      sqlite3_free(zErrMsg);
-      return -1;
-   } // end if 
- 
+   // no explicit transaction, sqlite commits the single insert
+   return AddDoorStateRow(timestamp, state, light, temperature, decision);
+} // end AddOneDoorStateRow
 
-   // execute sql statement 
-   rc = sqlite3_exec(_db, "begin", callback, 0, &zErrMsg);
-   if( rc != SQLITE_OK ){
-      _errorStr = "begin command error: ";
-      _errorStr += sqlite3_errmsg(_db);
-      sqlite3_free(zErrMsg);
-      sqlite3_close(_db);
-      return -1;
-   } // end if 
 
+int UpdateDatabase::AddSensorDataRow(time_t timestamp,
+                                     float temperature,
+                                     float humidity,
+                                     float light){
 
-   // build a insert sql command 
-   string sql = "insert into " + _dbDoorStateTable + "(timestamp, state, light, pi_temp, decision) values ";
-   sql += "('" + timestamp  + "', " + lexical_cast<string>(state) + ", '" + light  + "', '" + temperature + "', '" + decision + "')";
+   if(Open() != 0) return -1;
 
-   // execute sql statement to insert a row
-   rc = sqlite3_exec(_db, sql.c_str(), callback, 0, &zErrMsg);
-   if( rc != SQLITE_OK ){
-      _errorStr = "insert row: ";
+   if(sqlite3_bind_int64(_sensorDataStmt, 1, static_cast<sqlite3_int64>(timestamp)) != SQLITE_OK ||
+      sqlite3_bind_double(_sensorDataStmt, 2, temperature) != SQLITE_OK ||
+      sqlite3_bind_double(_sensorDataStmt, 3, humidity) != SQLITE_OK ||
+      sqlite3_bind_double(_sensorDataStmt, 4, light) != SQLITE_OK) {
+      _errorStr = "bind sensor data row: ";
       _errorStr += sqlite3_errmsg(_db);
-      sqlite3_free(zErrMsg);
-      sqlite3_close(_db);
+      sqlite3_reset(_sensorDataStmt);
       return -1;
-   } // end if 
+   } // end if
 
+   return StepInsert(_sensorDataStmt);
+} // end AddSensorDataRow
 
-   // execute end (commit) transition 
-   rc = sqlite3_exec(_db, "end", callback, 0, &zErrMsg);
-   if( rc != SQLITE_OK ){
-      _errorStr = "begin command error: ";
+
+int UpdateDatabase::AddOneSensorDataRow(time_t timestamp,
+                                        float temperature,
+                                        float humidity,
+                                        float light){
+
+   // no explicit transaction, sqlite commits the single insert
+   return AddSensorDataRow(timestamp, temperature, humidity, light);
+} // end AddOneSensorDataRow
+
+
+int UpdateDatabase::AddSunDataRow(const string &timestamp,
+                                  const string &sunrise,
+                                  const string &sunset){
+
+   if(Open() != 0) return -1;
+
+   if(BindText(_sunDataStmt, 1, timestamp) != 0 ||
+      BindText(_sunDataStmt, 2, sunrise) != 0 ||
+      BindText(_sunDataStmt, 3, sunset) != 0) {
+      _errorStr = "bind sun data row: ";
       _errorStr += sqlite3_errmsg(_db);
-      sqlite3_free(zErrMsg);
-      sqlite3_close(_db);
+      sqlite3_reset(_sunDataStmt);
       return -1;
-   } // end if 
-   
-   sqlite3_close(_db);
+   } // end if
 
-   return ret;
-} // end AddOneDoorStateRow
+   return StepInsert(_sunDataStmt);
+} // end AddSunDataRow
 
 
-int UpdateDatabase::AddSensorDataRow(const string &timestamp, 
-                                     const string &temperature,
-                                     const string &temperature_units,
-                                     const string &humidity,
-                                     const string &humidity_units,
-                                     const string &light,
-                                     const string &light_units){
+int UpdateDatabase::AddOneSunDataRow(const string &timestamp,
+                                     const string &sunrise,
+                                     const string &sunset){
 
-   int ret = 0; 
-   char *zErrMsg = 0;
+   // no explicit transaction, sqlite commits the single insert
+   return AddSunDataRow(timestamp, sunrise, sunset);
+} // end AddOneSunDataRow
 
-   // build a insert sql command 
-   string sql = "insert into " + _dbSensorDataTable + "(timestamp, temperature, " +
-                "temperature_units, humidity, humidity_units, light, light_units) values";
-   sql += "('" + timestamp  + "', '" + temperature + "', '" + temperature_units + "', '"
-               + humidity  + "', '" + humidity_units + "', '"
-               + light  + "', '" + light_units + "')";
 
+// WAL lets the web page and the chart program read while the writer
+// thread commits, readers no longer block on the rollback journal
+int UpdateDatabase::ConfigureConnection(){
 
-   // execute sql statement to insert a row
-   int rc = sqlite3_exec(_db, sql.c_str(), callback, 0, &zErrMsg);
-   if( rc != SQLITE_OK ){
-      _errorStr = "insert row: ";
+   sqlite3_busy_timeout(_db, DB_BUSY_TIMEOUT_MS);
+
+   if(ExecSql("pragma journal_mode = wal", "journal mode error: ") != 0) return -1;
+
+   // NORMAL in WAL mode only syncs at checkpoints, a power cut can lose
+   // the last commits but never corrupts the file
+   if(ExecSql("pragma synchronous = " + _synchronous, "synchronous error: ") != 0) return -1;
+
+   return 0;
+} // end ConfigureConnection
+
+
+int UpdateDatabase::GetSchemaVersion(int &version){
+   sqlite3_stmt *stmt = nullptr;
+
+   if(Prepare("pragma user_version", &stmt) != 0) return -1;
+
+   version = 0;
+   if(sqlite3_step(stmt) == SQLITE_ROW) {
+      version = sqlite3_column_int(stmt, 0);
+   } // end if
+
+   sqlite3_finalize(stmt);
+   return 0;
+} // end GetSchemaVersion
+
+
+// bring the file up to DB_SCHEMA_VERSION, each step runs in its own
+// transaction and bumps user_version so a step only ever runs once
+int UpdateDatabase::Migrate(){
+   int version = 0;
+
+   if(GetSchemaVersion(version) != 0) return -1;
+
+   if(version < 1) {
+      string doorState = QuoteIdentifier(_dbDoorStateTable);
+      string sensorData = QuoteIdentifier(_dbSensorDataTable);
+      string sunData = QuoteIdentifier(_dbSunDataTable);
+
+      // create the tables on a new file, the text columns match exe/create_db_tables.sql
+      string sql = "begin;"
+         "create table if not exists " + doorState + " ("
+         "id integer primary key autoincrement, timestamp text not null, state int not null, "
+         "light text not null, pi_temp text not null, decision text not null);"
+         "create table if not exists " + sensorData + " ("
+         "id integer primary key autoincrement, timestamp text not null, "
+         "temperature text not null, temperature_units text not null, "
+         "humidity text not null, humidity_units text not null, "
+         "light text not null, light_units text not null);"
+         "create table if not exists " + sunData + " ("
+         "id integer primary key autoincrement, timestamp text not null, "
+         "sunrise text not null, sunset text not null);"
+
+         // the chart reads timestamp, temperature, humidity and light for a time range,
+         // so cover all of them and the query never touches the table
+         "create index if not exists " + QuoteIdentifier(_dbSensorDataTable + "_timestamp_ix") +
+         " on " + sensorData + " (timestamp, temperature, humidity, light);"
+         "create index if not exists " + QuoteIdentifier(_dbDoorStateTable + "_timestamp_ix") +
+         " on " + doorState + " (timestamp);"
+         "create index if not exists " + QuoteIdentifier(_dbSunDataTable + "_timestamp_ix") +
+         " on " + sunData + " (timestamp);"
+         "pragma user_version = 1;"
+         "commit;";
+
+      if(ExecSql(sql, "schema version 1 error: ") != 0) {
+         // keep the migration error, not the rollback result
+         sqlite3_exec(_db, "rollback", nullptr, nullptr, nullptr);
+         return -1;
+      } // end if
+
+      version = 1;
+   } // end if
+
+   if(version < 2) {
+      string sensorData = QuoteIdentifier(_dbSensorDataTable);
+      string sensorDataV2 = QuoteIdentifier(_dbSensorDataTable + "_v2");
+      string units = QuoteIdentifier(_dbSensorDataTable + "_units");
+      string unparsed = QuoteIdentifier(_dbSensorDataTable + "_v1_unparsed");
+
+      // rebuild readings in place, the old text timestamps are local time
+      // so the 'utc' modifier converts them to utc epoch seconds. The per row
+      // unit strings were always the same, they move to the units table.
+      // A row whose timestamp doesn't parse is kept as is in <readings>_v1_unparsed
+      string sql = "begin;"
+         "create table if not exists " + unparsed + " as select * from " + sensorData +
+         " where strftime('%s', timestamp, 'utc') is null;"
+         "create table " + sensorDataV2 + " ("
+         "id integer primary key autoincrement, timestamp integer not null, "
+         "temperature real, humidity real, light real);"
+         "insert into " + sensorDataV2 + " (id, timestamp, temperature, humidity, light) "
+         "select id, cast(strftime('%s', timestamp, 'utc') as integer), "
+         "cast(temperature as real), cast(humidity as real), cast(light as real) "
+         "from " + sensorData + " where strftime('%s', timestamp, 'utc') is not null;"
+         "create table if not exists " + units + " ("
+         "name text primary key, units text not null);"
+         "insert or replace into " + units + " (name, units) values "
+         "('temperature', '" + SENSOR_TEMPERATURE_UNITS + "'), "
+         "('humidity', '" + SENSOR_HUMIDITY_UNITS + "'), "
+         "('light', '" + SENSOR_LIGHT_UNITS + "');"
+         "drop table " + sensorData + ";"
+         "alter table " + sensorDataV2 + " rename to " + sensorData + ";"
+         "create index " + QuoteIdentifier(_dbSensorDataTable + "_timestamp_ix") +
+         " on " + sensorData + " (timestamp, temperature, humidity, light);"
+         "pragma user_version = 2;"
+         "commit;";
+
+      if(ExecSql(sql, "schema version 2 error: ") != 0) {
+         sqlite3_exec(_db, "rollback", nullptr, nullptr, nullptr);
+         return -1;
+      } // end if
+
+      version = 2;
+   } // end if
+
+   if(version < 3) {
+      // one row per bucket, timestamp is the utc epoch start of the bucket
+      // and the integer primary key so range queries use the table b-tree
+      string columns = " (timestamp integer primary key, samples integer not null, "
+         "temperature_min real, temperature_max real, temperature_avg real, "
+         "humidity_min real, humidity_max real, humidity_avg real, "
+         "light_min real, light_max real, light_avg real);";
+
+      string sql = "begin;"
+         "create table if not exists " + QuoteIdentifier(_dbSensorDataTable + "_5min") + columns +
+         "create table if not exists " + QuoteIdentifier(_dbSensorDataTable + "_hourly") + columns +
+         "create table if not exists " + QuoteIdentifier(_dbSensorDataTable + "_rollup") + " ("
+         "name text primary key, watermark integer not null);"
+         "pragma user_version = 3;"
+         "commit;";
+
+      if(ExecSql(sql, "schema version 3 error: ") != 0) {
+         sqlite3_exec(_db, "rollback", nullptr, nullptr, nullptr);
+         return -1;
+      } // end if
+
+      version = 3;
+   } // end if
+
+   if(version < 4) {
+      string fiveMin = QuoteIdentifier(_dbSensorDataTable + "_5min");
+      string hourly = QuoteIdentifier(_dbSensorDataTable + "_hourly");
+      string rollupLight = " set light_min = light_min / " + DB_LIGHT_RESCALE_V4 +
+         ", light_max = light_max / " + DB_LIGHT_RESCALE_V4 +
+         ", light_avg = light_avg / " + DB_LIGHT_RESCALE_V4 + ";";
+
+      // every light value in the file is from before the lux fix, this
+      // runs once at startup before the first new row is written
+      string sql = "begin;"
+         "update " + QuoteIdentifier(_dbSensorDataTable) + " set light = light / " + DB_LIGHT_RESCALE_V4 + ";"
+         "update " + fiveMin + rollupLight +
+         "update " + hourly + rollupLight +
+         "update " + QuoteIdentifier(_dbDoorStateTable) +
+         " set light = printf('%.1f', cast(light as real) / " + DB_LIGHT_RESCALE_V4 + ");"
+         "pragma user_version = 4;"
+         "commit;";
+
+      if(ExecSql(sql, "schema version 4 error: ") != 0) {
+         sqlite3_exec(_db, "rollback", nullptr, nullptr, nullptr);
+         return -1;
+      } // end if
+
+      version = 4;
+   } // end if
+
+   return 0;
+} // end Migrate
+
+
+int UpdateDatabase::RollupSensorData(time_t now){
+
+   if(Open() != 0) return -1;
+
+   string fiveMin = _dbSensorDataTable + "_5min";
+   string hourly = _dbSensorDataTable + "_hourly";
+
+   // 5 minute buckets from the raw rows, then hourly buckets from the
+   // 5 minute rows but only as far as the 5 minute rollup has reached
+   int64_t fiveMinEnd = ((static_cast<int64_t>(now) - ROLLUP_LAG_SEC) / ROLLUP_5MIN_SEC) * ROLLUP_5MIN_SEC;
+   int64_t fiveMinMark = 0;
+   if(RollupTable("5min", _dbSensorDataTable, false, ROLLUP_5MIN_SEC, fiveMinEnd, fiveMinMark) != 0) return -1;
+
+   int64_t hourlyEnd = (fiveMinMark / ROLLUP_HOURLY_SEC) * ROLLUP_HOURLY_SEC;
+   int64_t hourlyMark = 0;
+   if(RollupTable("hourly", fiveMin, true, ROLLUP_HOURLY_SEC, hourlyEnd, hourlyMark) != 0) return -1;
+
+   // never prune rows the next rollup level hasn't read yet
+   if(_rawRetentionDays > 0) {
+      int64_t cutoff = min(static_cast<int64_t>(now) - static_cast<int64_t>(_rawRetentionDays) * 86400, fiveMinMark);
+      if(PruneTable(_dbSensorDataTable, "id", cutoff) != 0) return -1;
+   } // end if
+
+   if(_fiveMinRetentionDays > 0) {
+      int64_t cutoff = min(static_cast<int64_t>(now) - static_cast<int64_t>(_fiveMinRetentionDays) * 86400, hourlyMark);
+      if(PruneTable(fiveMin, "timestamp", cutoff) != 0) return -1;
+   } // end if
+
+   return 0;
+} // end RollupSensorData
+
+
+int UpdateDatabase::GetRecentDoorStates(size_t count, vector<DoorStateRow> &rows){
+
+   rows.clear();
+   if(Open() != 0) return -1;
+
+   // newest first for the limit, the old text timestamps are local time
+   string sql = "select cast(strftime('%s', timestamp, 'utc') as integer), state, light, pi_temp, decision "
+                "from " + QuoteIdentifier(_dbDoorStateTable) + " order by id desc limit ?";
+
+   sqlite3_stmt *stmt = nullptr;
+   if(Prepare(sql, &stmt) != 0) return -1;
+
+   sqlite3_bind_int64(stmt, 1, static_cast<sqlite3_int64>(count));
+
+   auto ColumnText = [stmt](int col) -> string {
+      const unsigned char *text = sqlite3_column_text(stmt, col);
+      return text != nullptr ? reinterpret_cast<const char *>(text) : "";
+   }; // end lambda
+
+   int ret = 0;
+   int rc;
+   while((rc = sqlite3_step(stmt)) == SQLITE_ROW) {
+      DoorStateRow row;
+      row.time = sqlite3_column_int64(stmt, 0);
+      row.state = sqlite3_column_int(stmt, 1);
+      row.light = ColumnText(2);
+      row.piTemp = ColumnText(3);
+      row.decision = ColumnText(4);
+      rows.push_back(row);
+   } // end while
+
+   if(rc != SQLITE_DONE) {
+      _errorStr = "query error: ";
       _errorStr += sqlite3_errmsg(_db);
-      sqlite3_free(zErrMsg);
-      sqlite3_close(_db);
       ret = -1;
-   } // end if 
+   } // end if
+
+   sqlite3_finalize(stmt);
 
+   std::reverse(rows.begin(), rows.end());
    return ret;
-} // end AddSensorDataRow
+} // end GetRecentDoorStates
+
+
+// aggregate [watermark, end) of source into bucketSec buckets of the
+// <readings>_<name> table, ROLLUP_SPAN_SEC of source per transaction.
+// watermark returns the end of the rolled up time, 0 if source is empty
+int UpdateDatabase::RollupTable(const string &name, const string &source, bool sourceIsRollup,
+                                int64_t bucketSec, int64_t end, int64_t &watermark){
+   string src = QuoteIdentifier(source);
+   string dst = QuoteIdentifier(_dbSensorDataTable + "_" + name);
+   string state = QuoteIdentifier(_dbSensorDataTable + "_rollup");
+   string bucket = "(timestamp / " + to_string(bucketSec) + ") * " + to_string(bucketSec);
+
+   // a rollup source already has min, max and avg, weight the avg by samples
+   string aggregate;
+   if(sourceIsRollup == true) {
+      aggregate = "sum(samples), "
+         "min(temperature_min), max(temperature_max), sum(temperature_avg * samples) / sum(samples), "
+         "min(humidity_min), max(humidity_max), sum(humidity_avg * samples) / sum(samples), "
+         "min(light_min), max(light_max), sum(light_avg * samples) / sum(samples)";
+   }
+   else {
+      aggregate = "count(*), "
+         "min(temperature), max(temperature), avg(temperature), "
+         "min(humidity), max(humidity), avg(humidity), "
+         "min(light), max(light), avg(light)";
+   } // end if
 
+   if(GetWatermark(name, watermark) != 0) return -1;
 
-int UpdateDatabase::AddOneSensorDataRow(const string &timestamp, 
-                                        const string &temperature,
-                                        const string &temperature_units,
-                                        const string &humidity,
-                                        const string &humidity_units,
-                                        const string &light,
-                                        const string &light_units){
-   int ret = 0; 
-   char *zErrMsg = 0;
+   for(int i = 0; i < ROLLUP_MAX_TRANSACTIONS && watermark < end; ++i) {
 
-   // open db use full path 
-   int rc = sqlite3_open(_dbFullPath.c_str(), &_db);
-   if(rc) {
-      _errorStr = "can't open database: ";
-      _errorStr += sqlite3_errmsg(_db);
-      sqlite3_free(zErrMsg);
-      return -1;
-   } // end if 
- 
+      // skip over any gap (first run, daemon down) to the next source row
+      int64_t next = 0;
+      bool isNull = false;
+      if(QueryInt64("select min(timestamp) from " + src +
+                    " where timestamp >= " + to_string(watermark), next, isNull) != 0) return -1;
 
-   // execute sql statement 
-   rc = sqlite3_exec(_db, "begin", callback, 0, &zErrMsg);
-   if( rc != SQLITE_OK ){
-      _errorStr = "begin command error: ";
-      _errorStr += sqlite3_errmsg(_db);
-      sqlite3_free(zErrMsg);
-      sqlite3_close(_db);
-      return -1;
-   } // end if 
+      if(isNull == true) break;
 
+      int64_t start = max(watermark, (next / bucketSec) * bucketSec);
+      if(start >= end) break;
 
-   // build a insert sql command 
-   string sql = "insert into " + _dbSensorDataTable + "(timestamp, temperature, " +
-                "temperature_units, humidity, humidity_units, light, light_units) values";
-   sql += "('" + timestamp  + "', '" + temperature + "', '" + temperature_units + "', '"
-               + humidity  + "', '" + humidity_units + "', '"
-               + light  + "', '" + light_units + "')";
+      int64_t stop = min(end, start + max(bucketSec, ROLLUP_SPAN_SEC));
 
-   // execute sql statement to insert a row
-   rc = sqlite3_exec(_db, sql.c_str(), callback, 0, &zErrMsg);
-   if( rc != SQLITE_OK ){
-      _errorStr = "insert row: ";
-      _errorStr += sqlite3_errmsg(_db);
-      sqlite3_free(zErrMsg);
-      sqlite3_close(_db);
-      return -1;
-   } // end if 
+      // insert or replace keeps a rerun of the same buckets harmless
+      string sql = "begin;"
+         "insert or replace into " + dst + " select " + bucket + ", " + aggregate +
+         " from " + src + " where timestamp >= " + to_string(start) +
+         " and timestamp < " + to_string(stop) + " group by 1;"
+         "insert or replace into " + state + " (name, watermark) values ('" + name + "', " +
+         to_string(stop) + ");"
+         "commit;";
 
+      if(ExecSql(sql, name + " rollup error: ") != 0) {
+         sqlite3_exec(_db, "rollback", nullptr, nullptr, nullptr);
+         return -1;
+      } // end if
 
-   // execute end (commit) transition 
-   rc = sqlite3_exec(_db, "end", callback, 0, &zErrMsg);
-   if( rc != SQLITE_OK ){
-      _errorStr = "begin command error: ";
+      watermark = stop;
+   } // end for
+
+   return 0;
+} // end RollupTable
+
+
+// delete the rows older than cutoff, ROLLUP_PRUNE_ROWS per transaction,
+// key is the rowid column of table
+int UpdateDatabase::PruneTable(const string &table, const string &key, int64_t cutoff){
+   string tbl = QuoteIdentifier(table);
+
+   // the timestamp index finds the oldest rows without a table scan
+   string sql = "delete from " + tbl + " where " + key + " in (select " + key +
+                " from " + tbl + " where timestamp < " + to_string(cutoff) +
+                " order by timestamp limit " + to_string(ROLLUP_PRUNE_ROWS) + ")";
+
+   for(int i = 0; i < ROLLUP_MAX_TRANSACTIONS; ++i) {
+
+      // autocommit, each delete is its own transaction
+      if(ExecSql(sql, table + " prune error: ") != 0) return -1;
+
+      if(sqlite3_changes(_db) < ROLLUP_PRUNE_ROWS) break;
+   } // end for
+
+   return 0;
+} // end PruneTable
+
+
+// watermark is the end of the rolled up time, 0 before the first rollup
+int UpdateDatabase::GetWatermark(const string &name, int64_t &watermark){
+   bool isNull = false;
+
+   watermark = 0;
+   if(QueryInt64("select watermark from " + QuoteIdentifier(_dbSensorDataTable + "_rollup") +
+                 " where name = '" + name + "'", watermark, isNull) != 0) return -1;
+
+   if(isNull == true) watermark = 0;
+
+   return 0;
+} // end GetWatermark
+
+
+// run a query for a single integer, isNull is true for no row or a null value
+int UpdateDatabase::QueryInt64(const string &sql, int64_t &value, bool &isNull){
+   sqlite3_stmt *stmt = nullptr;
+
+   if(Prepare(sql, &stmt) != 0) return -1;
+
+   int ret = 0;
+   isNull = true;
+
+   int rc = sqlite3_step(stmt);
+   if(rc == SQLITE_ROW) {
+      if(sqlite3_column_type(stmt, 0) != SQLITE_NULL) {
+         value = sqlite3_column_int64(stmt, 0);
+         isNull = false;
+      } // end if
+   }
+   else if(rc != SQLITE_DONE) {
+      _errorStr = "query error: ";
       _errorStr += sqlite3_errmsg(_db);
-      sqlite3_free(zErrMsg);
-      sqlite3_close(_db);
-      return -1;
-   } // end if 
-   
-   sqlite3_close(_db);
+      ret = -1;
+   } // end if
 
+   sqlite3_finalize(stmt);
    return ret;
-} // end AddOneSensorDataRow
+} // end QueryInt64
 
 
- int UpdateDatabase::AddOneSunDataRow(const string &timestamp, 
-                                      const string &sunrise,
-                                      const string &sunset){
+int UpdateDatabase::ExecSql(const string &sql, const string &errorPrefix){
    int ret = 0;
    char *zErrMsg = 0;
 
-   // open db use full path 
-   int rc = sqlite3_open(_dbFullPath.c_str(), &_db);
-   if(rc) {
-      _errorStr = "can't open database: ";
-      _errorStr += sqlite3_errmsg(_db);
-      sqlite3_free(zErrMsg);
-      return -1;
-   } // end if 
- 
-
-   // execute sql statement 
-   rc = sqlite3_exec(_db, "begin", callback, 0, &zErrMsg);
+   int rc = sqlite3_exec(_db, sql.c_str(), nullptr, 0, &zErrMsg);
    if( rc != SQLITE_OK ){
-      _errorStr = "begin command error: ";
+      _errorStr = errorPrefix;
       _errorStr += sqlite3_errmsg(_db);
-      sqlite3_free(zErrMsg);
-      sqlite3_close(_db);
-      return -1;
-   } // end if 
+      ret = -1;
+   } // end if
 
+   sqlite3_free(zErrMsg);
 
-   // build a insert sql command 
-   string sql = "insert into " + _dbSunDataTable + "(timestamp, sunrise, sunset) values";
-   sql += "('" + timestamp  + "', '" + sunrise + "', '" + sunset + "')";
+   return ret;
+} // end ExecSql
 
-   // execute sql statement to insert a row
-   rc = sqlite3_exec(_db, sql.c_str(), callback, 0, &zErrMsg);
-   if( rc != SQLITE_OK ){
-      _errorStr = "insert row: ";
+
+int UpdateDatabase::Prepare(const string &sql, sqlite3_stmt **stmt){
+
+   int rc = sqlite3_prepare_v2(_db, sql.c_str(), -1, stmt, nullptr);
+   if(rc != SQLITE_OK) {
+      _errorStr = "prepare statement error: ";
       _errorStr += sqlite3_errmsg(_db);
-      sqlite3_free(zErrMsg);
-      sqlite3_close(_db);
+      *stmt = nullptr;
       return -1;
-   } // end if 
+   } // end if
 
+   return 0;
+} // end Prepare
 
-   // execute end (commit) transition 
-   rc = sqlite3_exec(_db, "end", callback, 0, &zErrMsg);
-   if( rc != SQLITE_OK ){
-      _errorStr = "begin command error: ";
+
+int UpdateDatabase::BindText(sqlite3_stmt *stmt, int index, const string &value){
+
+   // SQLITE_TRANSIENT, sqlite makes its own copy of the value
+   int rc = sqlite3_bind_text(stmt, index, value.c_str(),
+                              static_cast<int>(value.size()), SQLITE_TRANSIENT);
+   return (rc == SQLITE_OK ? 0 : -1);
+} // end BindText
+
+
+// run a bound insert and reset the statement for the next row
+int UpdateDatabase::StepInsert(sqlite3_stmt *stmt){
+   int ret = 0;
+
+   int rc = sqlite3_step(stmt);
+   if(rc != SQLITE_DONE) {
+      _errorStr = "insert row: ";
       _errorStr += sqlite3_errmsg(_db);
-      sqlite3_free(zErrMsg);
-      sqlite3_close(_db);
-      return -1;
-   } // end if 
-   
-   sqlite3_close(_db);
+      ret = -1;
+   } // end if
+
+   sqlite3_reset(stmt);
+   sqlite3_clear_bindings(stmt);
 
    return ret;
-} // end AddOneSensorDataRow
+} // end StepInsert
+
+
+void UpdateDatabase::FinalizeStatements(){
 
+   // sqlite3_finalize() is a no-op on nullptr
+   sqlite3_finalize(_doorStateStmt);
+   sqlite3_finalize(_sensorDataStmt);
+   sqlite3_finalize(_sunDataStmt);
 
+   _doorStateStmt = nullptr;
+   _sensorDataStmt = nullptr;
+   _sunDataStmt = nullptr;
 
+} // end FinalizeStatements
 
 
+// table names come from the configuration file and can't be bound
+// as parameters, so quote them as sql identifiers
+string UpdateDatabase::QuoteIdentifier(const string &name){
+   string ret = "\"";
+
+   for(char c : name) {
+      if(c == '"') ret += '"';
+      ret += c;
+   } // end for
+
+   ret += "\"";
+   return ret;
+} // end QuoteIdentifier
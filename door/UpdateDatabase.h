@@ -1,7 +1,16 @@
 // file: UpdateDatabase.h header for UpdateDatabase
 // author: Bennett Cook
 // date: 07-05-2020
-// 
+// update: keep one connection open for the life of the process and
+//         insert rows with cached prepared statements
+// update: WAL journal, configurable synchronous level and a schema
+//         migration step keyed on PRAGMA user_version
+// update: schema 2, readings holds REAL values and epoch timestamps,
+//         the units move to the <readings>_units table
+// update: schema 3, 5 minute and hourly min/max/avg rollups of readings
+//         and retention pruning of the raw rows
+// update: schema 4, light written before the TSL2591 lux fix is rescaled
+//
 
 // header guard
 #ifndef UPDATEDATABASE_H
@@ -12,13 +21,67 @@
 
 #include <string>
 #include <tuple>
+#include <ctime>
+#include <cstdint>
+#include <vector>
+#include <algorithm>
 #include <boost/lexical_cast.hpp>
+#include <boost/algorithm/string.hpp>
 
 using namespace std;
 using namespace boost;
 
-// class to open and add a record to the database. The database is 
-// how data is passes to the web page  
+// the schema version this build expects, stored in PRAGMA user_version
+// 1: door_state, readings and sun_data plus the timestamp indexes
+// 2: readings timestamp is integer unix epoch (utc), the values are REAL,
+//    and the units are stored once in the <readings>_units table, old rows
+//    with a timestamp that doesn't parse are kept in <readings>_v1_unparsed
+// 3: <readings>_5min and <readings>_hourly rollup tables and the
+//    <readings>_rollup watermark table
+// 4: light in readings, the rollups and door_state written before the
+//    TSL2591 lux fix divided by DB_LIGHT_RESCALE_V4, all light is real lux
+const int DB_SCHEMA_VERSION = 4;
+
+// the old CalculateLux() used the gain and integration register bits
+// (16 and 2) for the 25x gain and 300 ms it ran at, 25 * 300 / (16 * 2)
+const string DB_LIGHT_RESCALE_V4 = "234.375";
+
+// units for the readings columns, written to the units table
+const string SENSOR_TEMPERATURE_UNITS = "degF";
+const string SENSOR_HUMIDITY_UNITS = "%";
+const string SENSOR_LIGHT_UNITS = "lx";
+
+// wait this long for a reader's lock before an insert fails with SQLITE_BUSY
+const int DB_BUSY_TIMEOUT_MS = 2000;
+
+// rollup bucket sizes in seconds
+const int64_t ROLLUP_5MIN_SEC = 300;
+const int64_t ROLLUP_HOURLY_SEC = 3600;
+
+// a bucket is rolled up this long after it ends so rows still in the
+// writer queue land before the bucket is read
+const int64_t ROLLUP_LAG_SEC = 60;
+
+// keep each rollup and prune transaction small, the writer thread
+// holds the write lock for the whole transaction
+const int64_t ROLLUP_SPAN_SEC = 6 * 3600;   /// source time rolled up per transaction
+const int ROLLUP_PRUNE_ROWS = 1000;          /// rows deleted per transaction
+const int ROLLUP_MAX_TRANSACTIONS = 16;      /// per table in one RollupSensorData() call
+
+// one door_state row read back, time is the utc epoch of the timestamp
+struct DoorStateRow {
+   int64_t time;
+   int state;
+   string light;
+   string piTemp;
+   string decision;
+}; // end struct
+
+// class to open and add a record to the database. The database is
+// how data is passes to the web page. The connection is opened on the
+// first use (or with Open()) and stays open until Close() or the dtor,
+// the insert statements are prepared once per table and the row
+// values are bound as parameters, never pasted into the sql text
 class UpdateDatabase {
 public:
 
@@ -30,66 +93,110 @@ public:
   int SetSensorDataTableName(const string &dbSensorDataTable);
   int SetSunDataTableName(const string &dbSunDataTable);
 
+  // one of OFF, NORMAL, FULL, EXTRA, applied by Open()
+  int SetSynchronous(const string &level);
+
+  // days of raw and 5 minute rows kept by RollupSensorData(), 0 keeps all,
+  // the hourly rollup is never pruned
+  int SetRetention(int rawDays, int fiveMinDays);
+
+  // open the connection and prepare the insert statements,
+  // return 0 if already open
+  int Open();
+  void Close();
+  bool IsOpen() { return _db != nullptr; }
+
+  // explicit transaction around several Add...Row() calls
+  int BeginTransaction();
+  int CommitTransaction();
+  int RollbackTransaction();
+
   int OpenAndBeginDB();
   int CommitAndCloseDB();
 
-  int AddDoorStateRow(const string &timestamp, 
+  // insert a row in the current transaction (see BeginTransaction())
+  int AddDoorStateRow(const string &timestamp,
                       int state,
-                      const string &light, 
+                      const string &light,
                       const string &temperature,
                       const string &decision);
 
 
-  int AddOneDoorStateRow(const string &timestamp, 
-                         int state, 
+  // insert a single row, sqlite commits it on its own
+  int AddOneDoorStateRow(const string &timestamp,
+                         int state,
                          const string &light,
                          const string &temperature,
                          const string &decision);
 
 
-  int AddSensorDataRow(const string &timeStamp, 
-                       const string &temperature,
-                       const string &temperature_units,
-                       const string &humidity,
-                       const string &humidity_units,
-                       const string &light,
-                       const string &light_units);
+  // timestamp is unix epoch seconds, units are in the units table
+  int AddSensorDataRow(time_t timestamp,
+                       float temperature,
+                       float humidity,
+                       float light);
 
 
-  int AddOneSensorDataRow(const string &timeStamp, 
-                         const string &temperature,
-                         const string &temperature_units,
-                         const string &humidity,
-                         const string &humidity_units,
-                         const string &light,
-                         const string &light_units);
+  int AddOneSensorDataRow(time_t timestamp,
+                          float temperature,
+                          float humidity,
+                          float light);
 
 
-  int AddOneSunDataRow(const string &timestamp, 
+  int AddSunDataRow(const string &timestamp,
+                    const string &sunrise,
+                    const string &sunset);
+
+
+  int AddOneSunDataRow(const string &timestamp,
                        const string &sunrise,
                        const string &sunset);
 
+  // roll the completed readings buckets into the 5 minute and hourly
+  // tables then prune the rows past retention. The work is done in small
+  // transactions and a call stops after ROLLUP_MAX_TRANSACTIONS per table,
+  // the next call picks up from the saved watermarks. Call it with no
+  // transaction open
+  int RollupSensorData(time_t now);
+
+  // the last count door_state rows, oldest first
+  int GetRecentDoorStates(size_t count, vector<DoorStateRow> &rows);
+
   string GetErrorStr() { return _errorStr; }
 
-private: 
+private:
 
   string _dbFullPath;
   string _dbDoorStateTable;
   string _dbSensorDataTable;
   string _dbSunDataTable;
+  string _synchronous;
+  int _rawRetentionDays;
+  int _fiveMinRetentionDays;
   string _errorStr;
   sqlite3 *_db;
 
-   // example from documentation
-   static int callback(void *NotUsed, int argc, char **argv, char **azColName) {
-      int i;
-      for(i = 0; i<argc; i++) {
-         printf("%s = %s\n", azColName[i], argv[i] ? argv[i] : "NULL");
-      }
-      printf("\n");
-      return 0;
-   } // end error callback
- 
+  // cached insert statements, one per table
+  sqlite3_stmt *_doorStateStmt;
+  sqlite3_stmt *_sensorDataStmt;
+  sqlite3_stmt *_sunDataStmt;
+
+  int ConfigureConnection();
+  int Migrate();
+  int GetSchemaVersion(int &version);
+  int ExecSql(const string &sql, const string &errorPrefix);
+  int Prepare(const string &sql, sqlite3_stmt **stmt);
+  int BindText(sqlite3_stmt *stmt, int index, const string &value);
+  int StepInsert(sqlite3_stmt *stmt);
+  void FinalizeStatements();
+  string QuoteIdentifier(const string &name);
+
+  int QueryInt64(const string &sql, int64_t &value, bool &isNull);
+  int GetWatermark(const string &name, int64_t &watermark);
+  int RollupTable(const string &name, const string &source, bool sourceIsRollup,
+                  int64_t bucketSec, int64_t end, int64_t &watermark);
+  int PruneTable(const string &table, const string &key, int64_t cutoff);
+
 }; // end class
 
-#endif // end header guard
\ No newline at end of file
+#endif // end header guard
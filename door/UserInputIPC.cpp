@@ -1,55 +1,164 @@
-
 #include "UserInputIPC.h"
+#include <unistd.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <cerrno>
+#include <cstring>
+#include <cstdio>
 
 
 UserInputIPC::UserInputIPC() : 
-   _userInput{' '} {
+   _fd{-1}, _recentCount{0} {
 } // end ctor 
 
 
 UserInputIPC::~UserInputIPC() {
+   Close();
 } // end dtor 
 
 
-bool UserInputIPC::NewFile() {
-   return fs::exists(MODE_FILE);
-} // end NewFile
+int UserInputIPC::Open() {
 
+   if(_fd >= 0) return 0;
 
-int UserInputIPC::ReadUserInput() {
-   int ret = -1;
-   string line;
+   string path = COMMAND_SOCKET.string();
+   sockaddr_un addr{};
+   addr.sun_family = AF_UNIX;
+   if(path.size() >= sizeof(addr.sun_path)) {
+      _errorStr = "command socket path is too long: " + path;
+      return -1;
+   } // end if 
+   strncpy(addr.sun_path, path.c_str(), sizeof(addr.sun_path) - 1);
 
-   // open a file in read mode.
-   ifstream infile(MODE_FILE.c_str());
-   if (infile.fail()) {
+   _fd = socket(AF_UNIX, SOCK_DGRAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+   if(_fd < 0) {
+      _errorStr = string("socket() failed: ") + strerror(errno);
       return -1;
-   } // end if
+   } // end if 
 
-   getline(infile, line, '\r');
-   infile.close();
+   // a socket file left by a run that didn't shut down blocks the bind
+   unlink(path.c_str());
 
-   if (line.size() >= 1) {
-      _userInput = line[0];
-      ret = 0;
-   }
-   else {
-      ret = -1;
+   if(bind(_fd, reinterpret_cast<sockaddr *>(&addr), sizeof(addr)) < 0) {
+      _errorStr = string("bind() ") + path + " failed: " + strerror(errno);
+      Close();
+      return -1;
    } // end if 
 
-   return ret;
-} // end ReadUserInput 
+   // the web server user sends to it, like the old mode file 0646
+   chmod(path.c_str(), 0666);
+
+   return 0;
+} // end Open
+
+
+void UserInputIPC::Close() {
+
+   if(_fd < 0) return;
+
+   close(_fd);
+   _fd = -1;
+   unlink(COMMAND_SOCKET.c_str());
+
+} // end Close
+
+
+int UserInputIPC::ReadCommands() {
+   int queued = 0;
+
+   if(_fd < 0) return 0;
+
+   while(true) {
+      char buf[64];
+      sockaddr_un from{};
+      socklen_t fromLen = sizeof(from);
+
+      ssize_t len = recvfrom(_fd, buf, sizeof(buf) - 1, 0, reinterpret_cast<sockaddr *>(&from), &fromLen);
+      if(len < 0) {
+         if(errno == EAGAIN || errno == EWOULDBLOCK) break;
+         if(errno == EINTR) continue;
+         _errorStr = string("recvfrom() failed: ") + strerror(errno);
+         return -1;
+      } // end if 
+      buf[len] = '\0';
+
+      // "<seq> <cmd>"
+      unsigned long seq = 0;
+      char cmd = '\0';
+      const char *answer = "error";
+
+      if(sscanf(buf, "%lu %c", &seq, &cmd) == 2) {
+         answer = QueueCommand(static_cast<uint32_t>(seq), cmd);
+         if(strcmp(answer, "ok") == 0) ++queued;
+      } // end if 
+
+      // a sender without a bound address can't get an answer
+      if(fromLen > sizeof(sa_family_t)) {
+         char reply[32];
+         int replyLen = snprintf(reply, sizeof(reply), "%lu %s", seq, answer);
+         sendto(_fd, reply, static_cast<size_t>(replyLen), MSG_DONTWAIT, 
+                reinterpret_cast<sockaddr *>(&from), fromLen);
+      } // end if 
+
+   } // end while 
+
+   return queued;
+} // end ReadCommands
+
+
+const char *UserInputIPC::QueueCommand(uint32_t seq, char cmd) {
+
+   UserInput input = CharToUserInput(cmd);
+
+   if(input == UserInput::Undefined) return "error";
+   if(IsRecent(seq) == true) return "dup";
+   if(_queue.size() >= COMMAND_QUEUE_SIZE) return "busy";
+
+   _queue.push_back(UserCommand{seq, input});
+   _recentSeq[_recentCount++ % COMMAND_SEQ_HISTORY] = seq;
+   return "ok";
+} // end QueueCommand
+
+
+// no seq, nothing to check a resend against
+const char *UserInputIPC::QueueCommand(char cmd) {
+
+   UserInput input = CharToUserInput(cmd);
+
+   if(input == UserInput::Undefined) return "error";
+   if(_queue.size() >= COMMAND_QUEUE_SIZE) return "busy";
+
+   _queue.push_back(UserCommand{0, input});
+   return "ok";
+} // end QueueCommand
+
+
+bool UserInputIPC::PopCommand(UserCommand &command) {
+
+   if(_queue.empty() == true) return false;
+
+   command = _queue.front();
+   _queue.pop_front();
+   return true;
+} // end PopCommand
+
+
+bool UserInputIPC::IsRecent(uint32_t seq) {
+   size_t count = _recentCount < COMMAND_SEQ_HISTORY ? _recentCount : COMMAND_SEQ_HISTORY;
 
+   for(size_t i = 0; i < count; ++i) {
+      if(_recentSeq[i] == seq) return true;
+   } // end for
 
-bool UserInputIPC::DeleteFile() {
-   return fs::remove(MODE_FILE);
-} // DeleteFile
+   return false;
+} // end IsRecent
 
 
-UserInput UserInputIPC::GetUserInput() {
+UserInput UserInputIPC::CharToUserInput(char c) {
    UserInput ret{ UserInput::Undefined };
 
-   switch (_userInput) {
+   switch (c) {
    case 'u':
       ret = UserInput::Manual_Up;
       break;
@@ -65,4 +174,4 @@ UserInput UserInputIPC::GetUserInput() {
    } // end switch
 
    return ret;
-} // end GetUserInput
+} // end CharToUserInput
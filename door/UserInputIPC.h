@@ -1,8 +1,10 @@
 #pragma once
 
-#include <fstream>
 #include <iostream>
 #include <string>
+#include <deque>
+#include <array>
+#include <cstdint>
 #include <filesystem>
 #include "CommonDef.h"
 
@@ -10,17 +12,58 @@ using namespace std;
 namespace fs = std::filesystem;
 
 
+// commands read and not yet taken by the main loop, more are refused
+const size_t COMMAND_QUEUE_SIZE = 32;
+
+// recent sequence numbers kept to drop a resent command
+const size_t COMMAND_SEQ_HISTORY = 16;
+
+
+// one web page command in the order it was received
+struct UserCommand {
+   uint32_t seq;
+   UserInput input;
+}; // end struct
+
+
+// command channel from the web page, a unix datagram socket at
+// COMMAND_SOCKET. A message is "<seq> <cmd>", cmd is u, d, a or c, and
+// seq is picked by the sender. Each message is answered to the sender
+// address with "<seq> ok", "<seq> dup" (already queued), "<seq> busy"
+// (queue full) or "<seq> error". A sender that gets no answer resends
+// with the same seq, so a command is never lost or run twice.
 class UserInputIPC {
 public:
    UserInputIPC(); 
    ~UserInputIPC();
 
-   bool NewFile();
-   int ReadUserInput(); 
-   bool DeleteFile();
-   UserInput GetUserInput();
+   // bind the socket, readable when a command arrives
+   int Open();
+   void Close();
+   int GetFd() { return _fd; }
+
+   // read every waiting message, queue and answer each one,
+   // return the number queued, -1 on error
+   int ReadCommands();
+
+   // queue a command from another channel (the http server) with the
+   // same checks, return "ok", "dup", "busy" or "error"
+   const char *QueueCommand(uint32_t seq, char cmd);
+   const char *QueueCommand(char cmd);
+
+   // oldest queued command, false if none
+   bool PopCommand(UserCommand &command);
+   size_t GetQueued() { return _queue.size(); }
+
+   string GetErrorStr() { return _errorStr; }
 
 private: 
-   char _userInput;
-}; // end 
+   int _fd;
+   deque<UserCommand> _queue;
+   std::array<uint32_t, COMMAND_SEQ_HISTORY> _recentSeq;
+   size_t _recentCount;
+   string _errorStr;
 
+   static UserInput CharToUserInput(char c);
+   bool IsRecent(uint32_t seq);
+}; // end 
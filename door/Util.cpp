@@ -3,59 +3,32 @@
 
 
 string GetSqlite3DateTime() {
+   time_t nowTime = time(nullptr);
+   tm timeinfo;
+   localtime_r(&nowTime, &timeinfo);
 
-   string ret;
-   ostringstream oss;
-
-   // get now time and convert to tm struct 
-   time_t nowTime;
-   time(&nowTime);
-   struct tm *timeinfo;
-   timeinfo = localtime(&nowTime);
-
-   oss << setw(4) << (timeinfo->tm_year + 1900) << "-";
-   oss << setw(2) << setfill('0') << (timeinfo->tm_mon + 1) << "-";
-   oss << setw(2) << setfill('0') << timeinfo->tm_mday << " ";
-   oss << setw(2) << setfill('0') << timeinfo->tm_hour << ":";
-   oss << setw(2) << setfill('0') << timeinfo->tm_min << ":";
-   oss << setw(2) << setfill('0') << timeinfo->tm_sec;
-   ret = oss.str();
-
-    return ret;
+   char buf[CLOCK_TIMESTAMP_SIZE];
+   ClockService::FormatSqlite3(timeinfo, buf);
+   return buf;
 } // end GetSqlite3DateTime
 
 
 string GetDateTimeFilename() {
+   time_t nowTime = time(nullptr);
+   tm timeinfo;
+   localtime_r(&nowTime, &timeinfo);
 
-   string ret;
-   ostringstream oss;
-
-   // get now time and convert to tm struct 
-   time_t nowTime;
-   time(&nowTime);
-   struct tm *timeinfo;
-   timeinfo = localtime(&nowTime);
-
-   oss << setw(4) << (timeinfo->tm_year + 1900) << "-";
-   oss << setw(2) << setfill('0') << (timeinfo->tm_mon + 1) << "-";
-   oss << setw(2) << setfill('0') << timeinfo->tm_mday << "_";
-   oss << setw(2) << setfill('0') << timeinfo->tm_hour;
-   oss << setw(2) << setfill('0') << timeinfo->tm_min;
-   oss << setw(2) << setfill('0') << timeinfo->tm_sec;
-   ret = oss.str();
-
-    return ret;
+   char buf[CLOCK_FILENAME_SIZE];
+   ClockService::FormatFilename(timeinfo, buf);
+   return buf;
 } // end GetDateTimeFilename
 
 bool IsAM() {
+   time_t nowTime = time(nullptr);
+   tm timeinfo;
+   localtime_r(&nowTime, &timeinfo);
 
-   // get now time and convert to tm struct 
-   time_t nowTime;
-   time(&nowTime);
-   struct tm *timeinfo;
-   timeinfo = localtime(&nowTime);
-
-   return timeinfo->tm_hour < 12;
+   return timeinfo.tm_hour < 12;
 } // end IsAM
 
 
@@ -63,8 +36,9 @@ bool IsAM() {
 IoValues MakeIoValuesMap(const vector<IoConfig> &io) {
    IoValues ret;
 
+   // the handles follow the configuration order
    for(auto iter = io.begin(); iter != io.end(); ++iter) {
-      ret.insert(make_pair(iter->name, 0));
+      ret.Add(iter->name);
    } // end for 
 
    return ret;  
@@ -80,8 +54,8 @@ void PrintIo(const IoValues &ioValues){
    oss << "name,value\n";
 
    // print data 
-   for(auto iter = ioValues.begin(); iter != ioValues.end(); ++iter) {
-      oss << iter->first << ", " << iter->second << "\n";
+   for(IoHandle h = 0; h < ioValues.Size(); ++h) {
+      oss << ioValues.Name(h) << ", " << ioValues.Get(h) << "\n";
    } // end for 
 
    string out = oss.str();
@@ -98,8 +72,8 @@ string IoToString(const IoValues &ioValues){
    oss << "name,value\n";
 
    // print data 
-   for(auto iter = ioValues.begin(); iter != ioValues.end(); ++iter) {
-      oss << iter->first << ", " << iter->second << "\n";
+   for(IoHandle h = 0; h < ioValues.Size(); ++h) {
+      oss << ioValues.Name(h) << ", " << ioValues.Get(h) << "\n";
    } // end for 
 
    return oss.str();
@@ -110,8 +84,8 @@ string IoToLine(const IoValues &ioValues){
    ostringstream oss;
 
    // print data 
-   for(auto iter = ioValues.begin(); iter != ioValues.end(); ++iter) {
-      oss << iter->first << ": " << iter->second << ", ";
+   for(IoHandle h = 0; h < ioValues.Size(); ++h) {
+      oss << ioValues.Name(h) << ": " << ioValues.Get(h) << ", ";
    } // end for 
    
    string out = oss.str();
@@ -150,10 +124,15 @@ int ReadBoardTemperature(string &temperature){
 } // end ReadBoardTemperature 
 
 
-void UpdateDoorStateDB(DoorState ds, UpdateDatabase &udb, string &light, string &temperature, string &decision) {
-   int result = udb.AddOneDoorStateRow(GetSqlite3DateTime(), static_cast<int>(ds), light, temperature, decision);
+// queue the row for the database writer thread, the state machine 
+// callback must not wait on the sd card, the timestamp is the clock's last tick
+void UpdateDoorStateDB(DoorState ds, DatabaseWriter &dbw, ClockService &clock, 
+                       string &light, string &temperature, string &decision) {
+   Log(LogLevel::Info, LogEvent::DoorState, static_cast<int>(ds), decision);
+
+   int result = dbw.PushDoorStateRow(clock.Sqlite3DateTime(), static_cast<int>(ds), light, temperature, decision);
    if(result != 0){
-      cout << "database write error: " << udb.GetErrorStr() << endl; 
+      Log(LogLevel::Warn, LogEvent::DbRowDropped, "door state");
    } // end if 
    return;
 } // end UpdateDoorStateDB
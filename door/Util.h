@@ -25,20 +25,24 @@
 #include <type_traits>
 
 #include "CommonDef.h"
-#include "UpdateDatabase.h"
+#include "DatabaseWriter.h"
 #include "PrintUtils.h"
+#include "TimerService.h"
+#include "ClockService.h"
+#include "Logger.h"
 
 using namespace std::chrono_literals;
 using MsDuration = std::chrono::duration<int, std::ratio<1, 1000>>;
 using namespace std;
 
 // return a date string in standard format "YYYY-MM-DD HH:MM:SS" with  the current date and time  
+// the main loop uses ClockService::Sqlite3DateTime(), cached on the tick
 string GetSqlite3DateTime();
 
-// return a date time string in format "YYYY-MM-DD HH-MM-SS" with the current date and time 
+// return a date time string in format "YYYY-MM-DD_HHMMSS" with the current date and time 
 string GetDateTimeFilename();
 
-// is time in AM
+// is time in AM, the main loop uses ClockService::IsAM()
 bool IsAM();
 
 // 
@@ -48,7 +52,8 @@ string IoToString(const IoValues &ioValues);
 string IoToLine(const IoValues &ioValues);
 
 int ReadBoardTemperature(string &temperature);
-void UpdateDoorStateDB(DoorState ds, UpdateDatabase &udb, string &light, string &temperature, string &decision);
+void UpdateDoorStateDB(DoorState ds, DatabaseWriter &dbw, ClockService &clock, 
+                       string &light, string &temperature, string &decision);
 
 
 // conditional print  with optional newline
@@ -96,18 +101,19 @@ private:
 
 
 
-// need a better implementation, this works but will be better with boost::asio 
+// one shot timer for the state machine, a named slot in the TimerService.
+// Expiry is handled by TimerService::Dispatch() on the main loop thread,
+// so there is no thread per timer and Cancel() does not block
 class NoBlockTimer {
 public:
 
-   NoBlockTimer() {
-      _msd = MsDuration{0};
-      _done = false;
-      _running = false;
-      _kill = false;
+   NoBlockTimer(TimerService &timers, const string &name) : _timers(timers) {
+      _handle = _timers.Create(name);
+      _ms = 0;
    } // end ctor 
 
    ~NoBlockTimer() {
+      _timers.Cancel(_handle);
    } // end dtor 
 
    // return 0 success
@@ -115,93 +121,51 @@ public:
    int SetupTimer(unsigned msd){
       int ret = 0;
 
-      if(_running == false) {
-         _msd = MsDuration{msd};
-         _done = false;
-         _kill = false;
+      if(_timers.IsRunning(_handle) == false) {
+         _ms = msd;
+         _timers.Cancel(_handle);
       }
       else {
          ret = -1;
       } // end if 
 
-      PrintLn((boost::format{ "SetupTimer: ret=%1% tm: %2%" } % ret % msd).str());
+      Log(LogLevel::Info, LogEvent::TimerSetup, ret, msd);
       return ret;
    } // end SetupTimer
 
 
    // return 0 success
-   // return -1 timer is already running
+   // return -1 timer is already running or the timerfd failed
    int StartTimer(){
       int ret = 0;
 
-      if(_running == false) {
-         _running = true;
-         std::thread th([=]() {this->TimerTask(); });
-         th.detach();
+      if(_timers.IsRunning(_handle) == false) {
+         ret = _timers.Start(_handle, _ms);
       }
       else {
          ret = -1;
       } // end if 
 
-      PrintLn((boost::format{ "StartTimer: ret=%1%" } % ret).str());
+      Log(LogLevel::Info, LogEvent::TimerStart, ret);
       return ret;
    } // end StartTimer
 
    // returns timer done status 
    // remark if time is done returns true and then resets internal done status 
    bool IsDone() {
-      bool ret = _done;
-
-      if(_done == true) {
-         _done = false;
-      } // end if 
-
-      return ret; 
+      return _timers.IsDone(_handle);
    } // end IsDone
 
    // cancels the timer (if running) and resets internal done status 
    void Cancel() {
-      _kill = true;
-      std::this_thread::sleep_for(25ms);
-      _done = false;
-      _running = false;
-      return;
+      _timers.Cancel(_handle);
    } // end Cancel
 
 private:
 
-   MsDuration _msd;
-   bool _done;
-   bool _running;
-   bool _kill;
-
-   void TimerTask() {
-      MsDuration tc = 0ms;
-
-      PrintLn((boost::format{ "TimerTask: start: ms: %1%" } % _msd.count()).str());
-      
-      while(!_done){
-         
-         if(_kill) break;
-
-         std::this_thread::sleep_for(25ms);
-         tc += 25ms;
-      
-         if(tc >= _msd) {
-            _done = true;
-         } // end if 
-
-         if(_kill) break;
-
-      } // end while 
-
-      PrintLn((boost::format{ "TimerTask: done: %1%" } % _done).str());
-
-      _running = false;
-      _kill = false;
-
-      return;
-   } // end TimerTask
+   TimerService &_timers;
+   TimerHandle _handle;
+   unsigned _ms;
 
 }; // end class 
 
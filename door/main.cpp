@@ -8,7 +8,7 @@
 #include <iomanip>
 #include <functional> 
 #include <ctime>
-#include <boost/coroutine2/all.hpp>
+#include <cstring>
 
 #include "CommonDef.h"
 #include "wiringPi.h"
@@ -17,7 +17,11 @@
 #include "DigitalIO.h"
 #include "Rp4bPwm.h"
 #include "Util.h"
+#include "ClockService.h"
 #include "UpdateDatabase.h"
+#include "DatabaseWriter.h"
+#include "EventLoop.h"
+#include "Logger.h"
 #include "StateMachine.hpp"
 #include "Camera.h"
 #include "PiTempReader.h"
@@ -26,11 +30,13 @@
 #include "PrintUtils.h"
 #include "UserInputIPC.h"
 #include "DateTimeUtils.h"
+#include "SunTable.h"
 #include "SunriseSunset.h"
+#include "CoopStatus.h"
+#include "HttpServer.h"
 
 using namespace std;
 using Ccsm = sm_chicken_coop;
-using namespace boost::coroutines2;
 namespace sml = boost::sml;
 namespace fs = std::filesystem;
 
@@ -91,6 +97,17 @@ int main(int argc, char* args[]){
    // passed to to other classes in the app
    AppConfig ac = rcf.GetConfiguration();
 
+   // binary event log with rotation, read it with the logdecode tool.
+   // the program runs without it
+   Logger &logger = Logger::Instance();
+   result = logger.Open(ac.logPath, ac.logMaxBytes > 0 ? ac.logMaxBytes : 0, ac.logFiles > 0 ? ac.logFiles : 1,
+                        LogLevelFromString(ac.logLevel));
+   if(result != 0) {
+      cout << "log error: " << logger.GetErrorStr() << ", logging off" << endl;
+   } // end if 
+
+   Log(LogLevel::Info, LogEvent::ProgramStart, ac.appName);
+
    // set the sqlite3 file path in the database class
    UpdateDatabase udb;
    udb.SetDbFullPath(ac.dbPath);
@@ -98,18 +115,66 @@ int main(int argc, char* args[]){
    udb.SetSensorDataTableName(ac.dbSensorTable);
    udb.SetSunDataTableName(ac.dbSunDataTable);
 
+   result = udb.SetSynchronous(ac.dbSynchronous);
+   if(result != 0) {
+      cout << "configuration file error: " << udb.GetErrorStr() << endl;
+      return 0;
+   } // end if 
+
+   result = udb.SetRetention(ac.dbRawRetentionDays, ac.db5MinRetentionDays);
+   if(result != 0) {
+      cout << "configuration file error: " << udb.GetErrorStr() << endl;
+      return 0;
+   } // end if 
+
+   // open the long lived connection now so a bad path or a failed 
+   // schema migration shows up at startup,
+   // the writes still retry the open if this fails 
+   result = udb.Open();
+   if(result != 0) {
+      cout << "database open error: " << udb.GetErrorStr() << endl;
+   } // end if 
+
+   // the last door states for the status history, read before the 
+   // writer thread owns udb
+   vector<DoorStateRow> recentDoorStates;
+   if(udb.IsOpen() && udb.GetRecentDoorStates(COOP_STATUS_HISTORY, recentDoorStates) != 0) {
+      cout << "door state history error: " << udb.GetErrorStr() << endl;
+   } // end if 
+
+   // from here on only the writer thread uses udb, the loop just queues rows
+   DatabaseWriter dbw(udb, ac.dbQueueSize, ac.dbBatchRows, ac.dbBatchMS);
+   dbw.SetRollupIntervalSec(ac.dbRollupIntervalSec > 0 ? ac.dbRollupIntervalSec : 0);
+   result = dbw.Start();
+   if(result != 0) {
+      cout << "database writer error: " << dbw.GetErrorStr() << endl;
+      return 0;
+   } // end if 
+
    // make a digial io class and configure digital io points
    DigitalIO digitalIo;
    digitalIo.SetIoPoints(ac.dIos);
    digitalIo.ConfigureHardware();
 
-   // setup empty IoValue map used for algo data 
+   // setup empty IoValue map used for algo data, the names are
+   // resolved to pins once here
    IoValues ioValues = MakeIoValuesMap(ac.dIos);
+   result = digitalIo.BindIoValues(ioValues);
+   if(result != 0) {
+      cout << "configuration file error: " << digitalIo.GetErrorStr() << endl;
+      return 0;
+   } // end if 
+   PrintLn("gpio bank register io: %1%", digitalIo.IsBulkIo() ? "on" : "off");
 
    Rp4bPwm pwm(PwmNumber::Pwm1);
-   pwm.SetFrequenceHz(ac.pwmHzHoming); 
-   pwm.SetDutyCyclePercent(50);
-   pwm.Enable(false);
+   result = pwm.IsReserved() == true ? 0 : -1;
+   if(result == 0) result = pwm.SetFrequenceHz(ac.pwmHzHoming); 
+   if(result == 0) result = pwm.SetDutyCyclePercent(50);
+   if(result == 0) result = pwm.Enable(false);
+   if(result != 0) {
+      cout << "pwm error: " << pwm.GetErrStr() << endl;
+      return 0;
+   } // end if 
 
    ioValues["enable"] = 0u;     // 0 = on at stepper controller
    ioValues["direction"] = 1u;  // 1 = off at stepper controller
@@ -121,7 +186,7 @@ int main(int argc, char* args[]){
    // read all now so the eInit{} in state machine has fresh data 
    result = digitalIo.ReadAll(ioValues);
    if(result != 0){
-      PrintLn((boost::format{ "read gpio error: %1%" } % digitalIo.GetErrorStr()).str());
+      Log(LogLevel::Error, LogEvent::GpioReadError, digitalIo.GetErrorStr());
    } // end if 
 
    // reader for pi temp
@@ -140,23 +205,52 @@ int main(int argc, char* args[]){
 
    // readers for ambient sensor temp, humidity, and light
    Si7021Reader si7021r;
+   si7021r.SetOptions(ac.si7021HoldMode, ac.si7021CheckCrc);
    Tsl2591Reader tsl2591r;
    float light = 0.0f;
    string lightStr = "0.0";
-   SmoothingFilter<float> lightQueue(7); // try the queue size of 7 
+   int lightReadSec = ac.lightReadIntervalSec > 0 ? ac.lightReadIntervalSec : DEFAULT_LIGHT_READ_INTERVAL_SEC;
+   SmoothingFilter<float> lightQueue(max(1, (LIGHT_FILTER_WINDOW_SEC + lightReadSec / 2) / lightReadSec)); 
+
+   // all the program timers share one timerfd, expired timers are
+   // handled by timers.Dispatch() at the top of the loop
+   TimerService timers;
+   result = timers.Open();
+   if(result != 0){
+      cout << "timer service error: " << timers.GetErrorStr() << endl;
+      return 0;
+   } // end if 
 
-   NoBlockTimer nbTimer;
+   NoBlockTimer nbTimer(timers, "door");
+
+   // the time of the loop pass, sampled once by clockService.Tick()
+   ClockService clockService;
    Ccsm ccsm(ioValues, ac, pwm, nbTimer);
 
    // used in the decision section in while() to document 
    // what decision was taken, dec is added to the door state table
    Decision dec = Decision::Undefined;
 
+   // live status for the web page, see CoopStatus.h
+   CoopStatus coopStatus;
+   result = coopStatus.Create();
+   if(result != 0) {
+      cout << "status error: " << coopStatus.GetErrorStr() << ", no live status for the web page" << endl;
+   } // end if 
+
+   // start the history where the last run left it, oldest first
+   for(const DoorStateRow &row : recentDoorStates) {
+      coopStatus.AddDoorState(row.time, row.state, static_cast<int32_t>(DecisionFromString(row.decision)),
+                              strtof(row.light.c_str(), nullptr), strtof(row.piTemp.c_str(), nullptr));
+   } // end for 
+
    // lambda as callback from the state machine to set a door_state table
    // see int SetStateMachineCB() im StateMachine.hpp
    auto SetDoorStateTableFromSM = [&] (DoorState ds){
       string decStr = DecisionToString(dec); 
-      UpdateDoorStateDB(ds, udb, lightStr, temperature, decStr);
+      UpdateDoorStateDB(ds, dbw, clockService, lightStr, temperature, decStr);
+      coopStatus.AddDoorState(clockService.Now(), static_cast<int32_t>(ds), static_cast<int32_t>(dec), 
+                              light, strtof(temperature.c_str(), nullptr));
    }; // end lambda
 
    // set the callback from main SetOutputFromSM() into the statemachine.hpp SetStateMachineCB()
@@ -178,30 +272,201 @@ int main(int argc, char* args[]){
 
    // class to read the webpage user selected mode through ipc 
    UserInputIPC uiIpc;
+   result = uiIpc.Open();
+   if(result != 0) {
+      cout << "command socket error: " << uiIpc.GetErrorStr() << ", no web page commands" << endl;
+   } // end if 
 
    // mode and takePicture are user input from either cin or the web page through IPC 
    UserInput mode = UserInput::Auto_Mode;
    UserInput takePicture = UserInput::Undefined;
 
    // class to test if day or night
-   Daytime daytime{ac.sunriseOffsetMin, ac.sunsetOffsetMin};
+   // sun times for the configured location, made again when the location changes
+   SunTable sunTable;
+   result = sunTable.Open(ac.sunTablePath, ac.latitude, ac.longitude);
+   if(result != 0) {
+      cout << "sun table error: " << sunTable.GetErrorStr() << ", using the light sensor" << endl;
+   } // end if 
+
+   Daytime daytime{sunTable, ac.sunriseOffsetMin, ac.sunsetOffsetMin};
    bool daytimeDataAvailable = false;
 
    // set true when the light averaging is saturated
    bool lightDataAvaliable = false;
 
-   // setr address struct from the configuration
-   Address address{ac.houseNumber, ac.street, ac.city, ac.state, ac.zipCode};
+   // today's times now, then a timer deadline at Time2Check4NewSunriseSunset
+   // each day, the loop only polls the status
+   SunriseSunset srss{sunTable, timers, Time2Check4NewSunriseSunset};
+   result = srss.Start();
+   if(result != 0){
+      cout << "sunrise sunset timer error: " << srss.GetError() << endl;
+   } // end if 
+
+   // the loop waits on the event loop, woken by the tick, stdin, the web
+   // page command socket and reader completions. The tick is loop_time_ms
+   // while the door moves and idle_tick_ms at rest, so that bounds the
+   // reaction time. event_loop false keeps the fixed sleep_for(loop_time_ms)
+   EventLoop loop;
+   HttpServer http(loop);
+   bool useEventLoop = ac.eventLoop;
+   bool consoleReady = false;
+   bool ticked = true;
+
+   if(useEventLoop == true) {
+      result = loop.Open();
+      if(result == 0) 
+         result = loop.SetTickMS(ac.loopTimeMS);
+
+      if(result != 0) {
+         cout << "event loop error: " << loop.GetErrorStr() << ", using the fixed loop time" << endl;
+         useEventLoop = false;
+      } // end if 
+   } // end if 
+
+   if(useEventLoop == true) {
+
+      // stdin is /dev/null when run as a service and epoll can't watch it,
+      // the web page input still works so only note it
+      result = loop.Add(STDIN_FILENO, EPOLLIN, [&](uint32_t events) {
+         consoleReady = true;
+         if(events & (EPOLLHUP | EPOLLERR)) loop.Remove(STDIN_FILENO);
+      });
+      if(result != 0) {
+         PrintLn("console input not watched: %1%", loop.GetErrorStr());
+      } // end if 
+
+      // web page commands are read and answered as soon as they arrive
+      if(uiIpc.GetFd() >= 0) {
+         loop.Add(uiIpc.GetFd(), EPOLLIN, [&](uint32_t) { 
+            if(uiIpc.ReadCommands() < 0) PrintLn(uiIpc.GetErrorStr());
+         });
+      } // end if 
+
+      // the handler is Dispatch() at the top of the loop
+      result = loop.Add(timers.GetFd(), EPOLLIN, nullptr);
+      if(result != 0) {
+         cout << "timer watch error: " << loop.GetErrorStr() << ", timers checked on the tick" << endl;
+      } // end if 
+
+      auto wake = [&loop]() { loop.Wakeup(); };
+      pitr.SetNotify(wake);
+      si7021r.SetNotify(wake);
+      tsl2591r.SetNotify(wake);
+
+      // limit switch and obstruction edges wake the loop at once,
+      // without them the inputs are still read on every tick
+      if(ac.gpioEdgeEvents == true) {
+         string edgeError;
+         result = digitalIo.EnableEdgeEvents(ac.gpioDebounceUs > 0 ? ac.gpioDebounceUs : 0);
+         if(result != 0) {
+            edgeError = digitalIo.GetErrorStr();
+         }
+         else {
+            result = loop.Add(digitalIo.GetEdgeFd(), EPOLLIN, [&](uint32_t) { 
+               if(digitalIo.ReadEdges() != 0) PrintLn(digitalIo.GetErrorStr());
+            });
+            if(result != 0) edgeError = loop.GetErrorStr();
+         } // end if 
+
+         if(result != 0) {
+            cout << "gpio edge events error: " << edgeError << ", reading the inputs on the tick" << endl;
+            digitalIo.DisableEdgeEvents();
+         } // end if 
+      } // end if 
+
+      // json status and commands over http, answered in loop.Wait(). 
+      // a command goes on the same queue as the web page socket commands
+      if(ac.httpPort > 0) {
+         http.AddRoute("GET", "/status", [&](const HttpRequest &, HttpResponse &response) {
+            response.body = CoopStatusToJson(coopStatus.Data());
+         });
+
+         http.AddRoute("GET", "/history", [&](const HttpRequest &, HttpResponse &response) {
+            response.body = CoopStatusHistoryToJson(coopStatus.Data());
+         });
+
+         // date=yyyy-mm-dd (default today) and days=<n> (default 1, at most 366)
+         http.AddRoute("GET", "/sun", [&](const HttpRequest &request, HttpResponse &response) {
+            date first = day_clock::local_day();
+            string dateStr = HttpFormValue(request.query, "date");
+            int count = atoi(HttpFormValue(request.query, "days").c_str());
+
+            try {
+               if(dateStr.empty() == false) first = from_simple_string(dateStr);
+            }
+            catch(std::exception &) {
+               response.status = 400;
+               return;
+            } // end try/catch
+
+            if(sunTable.IsOpen() == false) {
+               response.status = 503;
+               return;
+            } // end if 
+
+            response.body = sunTable.ToJson(first, count < 1 ? 1 : (count > 366 ? 366 : count));
+         });
+
+         // cmd=u|d|a|c in the form body or the query, seq=<n> is optional, 
+         // a resend with the same seq is answered dup and not run twice
+         http.AddRoute("POST", "/command", [&](const HttpRequest &request, HttpResponse &response) {
+            string cmd = HttpFormValue(request.body, "cmd");
+            string seq = HttpFormValue(request.body, "seq");
+            if(cmd.empty() == true) cmd = HttpFormValue(request.query, "cmd");
+            if(seq.empty() == true) seq = HttpFormValue(request.query, "seq");
+
+            const char *answer = "error";
+            if(cmd.size() == 1) {
+               answer = seq.empty() == true ? uiIpc.QueueCommand(cmd[0]) : 
+                        uiIpc.QueueCommand(static_cast<uint32_t>(strtoul(seq.c_str(), nullptr, 10)), cmd[0]);
+            } // end if 
+
+            if(strcmp(answer, "error") == 0) response.status = 400;
+            if(strcmp(answer, "busy") == 0) response.status = 503;
+            response.body = string("{\"result\":\"") + answer + "\"}";
+         });
+
+         result = http.Open(ac.httpAddress, static_cast<uint16_t>(ac.httpPort));
+         if(result != 0) {
+            cout << "http server error: " << http.GetErrorStr() << ", no http status or commands" << endl;
+         } // end if 
+      } // end if 
+   }
+   else if(ac.httpPort > 0) {
+      cout << "http server needs the event loop, no http status or commands" << endl;
+   } // end if 
 
-   SunriseSunset srss{address, Time2Check4NewSunriseSunset};
-   std::function<void(coroutine<SunriseSunsetStatus>::push_type &)> fn = 
-      std::bind(&SunriseSunset::FetchTimes, &srss, std::placeholders::_1);
+   // send the inputs and door command to the state machine 
+   auto ProcessStateMachine = [&](DoorCommand doorCommand) {
+      if(doorHomed == false){
+         sm.process_event(eStartUp{});
+      } 
+      else if(lightDataAvaliable == true || daytimeDataAvailable == true){
+         sm.process_event(eOnTime{doorCommand});
+      } // end if 
+      // note: do nothing on else 
+
+      if(sm.is(sml::state<HomingComplete>) == true) 
+         doorHomed = true;
+   }; // end lambda
 
-   // declare the coroutine GetSunriseSunsetTimes
-   coroutine<SunriseSunsetStatus>::pull_type GetSunriseSunsetTimes{ fn };
+   // last values given to the state machine, see the dispatch below
+   IoValues lastIoValues;
+   DoorCommand lastDc{DoorCommand::NoChange};
 
    while(true) {
 
+      // the clocks for the whole pass, the monotonic sample is also the
+      // start of the work time published with the status
+      clockService.Tick();
+
+      // fire the expired timers, the state machine sees them through IsDone()
+      int timersFired = timers.Dispatch();
+      if(timersFired < 0) {
+         PrintLn("timer error: %1%", timers.GetErrorStr());
+      } // end if 
+
       //////////////////////////////////////////////////////
       // if user types p <enter> enable PrintLn()
       // if user types s <enter> disable PrintLn()
@@ -209,7 +474,18 @@ int main(int argc, char* args[]){
       // if user types u enter manual mode, door up
       // if user types d  enter manual mode, door down
       // if user types a auto mode
-      if(wc.CheckForInput() == true) {
+      bool consoleInput = false;
+      if(useEventLoop == true) {
+         if(consoleReady == true) {
+            consoleReady = false;
+            consoleInput = wc.ReadLine();
+         } // end if 
+      }
+      else {
+         consoleInput = wc.CheckForInput();
+      } // end if 
+
+      if(consoleInput == true) {
          string in = wc.GetInput();
          if(in[0] == 'q') break;
 
@@ -228,22 +504,24 @@ int main(int argc, char* args[]){
 
       //////////////////////////////////////////////////////
       // look for a new mode selection from the webpage 
-      if(uiIpc.NewFile() == true) {
-         if(uiIpc.ReadUserInput() == 0) {
-            auto iuCmd = uiIpc.GetUserInput();
-            uiIpc.DeleteFile();
-            PrintLn((boost::format{ "new user input: %1%" } % UserInputToString(iuCmd)).str());
-
-            // separate out manual door commands from the take picture command  
-            if(iuCmd == UserInput::Take_Picture)
-               takePicture = UserInput::Take_Picture;
-            else 
-               mode = iuCmd;
+      // the event loop reads the socket when it is readable
+      if(useEventLoop == false) {
+         if(uiIpc.ReadCommands() < 0) PrintLn(uiIpc.GetErrorStr());
+      } // end if 
 
-         }
-         else {
-            PrintLn("read mode file error");
-         } // end if 
+      // one command per pass so each reaches the state machine,
+      // wake the loop right away for the next one
+      UserCommand webCmd;
+      if(uiIpc.PopCommand(webCmd) == true) {
+         Log(LogLevel::Info, LogEvent::UserInput, UserInputToString(webCmd.input), webCmd.seq);
+
+         // separate out manual door commands from the take picture command  
+         if(webCmd.input == UserInput::Take_Picture)
+            takePicture = UserInput::Take_Picture;
+         else 
+            mode = webCmd.input;
+
+         if(useEventLoop == true && uiIpc.GetQueued() > 0) loop.Wakeup();
       } // end if 
 
       // end look for a new mode selection from the webpage 
@@ -251,20 +529,25 @@ int main(int argc, char* args[]){
 
       //////////////////////////////////////////////////////
       // get sunrise sunset times   
-      auto status = GetSunriseSunsetTimes().get();
+      auto status = srss.Poll();
       if (status == SunriseSunsetStatus::SunRiseSetComplete) {
          auto times = srss.GetTimes();
          
          // save new sun data time to the database
-         int sunDataWriteResult = udb.AddOneSunDataRow(GetSqlite3DateTime(),
-                                                       Ptime2TmeString(times.rise), 
-                                                       Ptime2TmeString(times.set));
+         int sunDataWriteResult = dbw.PushSunDataRow(clockService.Sqlite3DateTime(),
+                                                     Ptime2TmeString(times.rise), 
+                                                     Ptime2TmeString(times.set));
          if(sunDataWriteResult == -1) {
-            cout << udb.GetErrorStr() << endl;
+            Log(LogLevel::Warn, LogEvent::DbRowDropped, "sun data");
          } // end if 
 
-         daytime.SetSunriseSunsetTimes(times.rise, times.set);
          daytimeDataAvailable = true;
+
+         // the times are local, mktime() gives the epoch
+         tm riseTm = to_tm(times.rise);
+         tm setTm = to_tm(times.set);
+         coopStatus.Data().sunrise = mktime(&riseTm);
+         coopStatus.Data().sunset = mktime(&setTm);
       }
       else if (status == SunriseSunsetStatus::Error) {
          daytimeDataAvailable = false;
@@ -294,7 +577,7 @@ int main(int argc, char* args[]){
       }
       else if(daytimeDataAvailable == true){
 
-         if(daytime.IsDaytime()){
+         if(daytime.IsDaytime(clockService.Now())){
             dc = DoorCommand::Open;
             dec = Decision::Sunrise_W_Offset;
          }
@@ -306,12 +589,12 @@ int main(int argc, char* args[]){
       } 
       else if(lightDataAvaliable == true){
 
-         if(light > ac.morningLight && IsAM()) {
+         if(light > ac.morningLight && clockService.IsAM()) {
             dc = DoorCommand::Open;
             dec = Decision::AM_Light;
          } // end if 
          
-         if(light < ac.nightLight && !IsAM()) { 
+         if(light < ac.nightLight && !clockService.IsAM()) { 
             dc = DoorCommand::Close;
             dec = Decision::PM_Light;
          } // end if 
@@ -326,22 +609,38 @@ int main(int argc, char* args[]){
       // main control loop, read input solve logic, set outputs
       // there are other input/outputs but the IO is the main things
       // for the state machine 
+      // replay the queued input edges in kernel order, one state machine
+      // event each, so a short obstruction pulse is not lost between reads
+      IoEdge edge;
+      while(digitalIo.PopEdge(edge) == true) {
+         ioValues.Set(edge.handle, edge.value);
+         ProcessStateMachine(dc);
+         digitalIo.SetOutputs(ioValues);
+
+         timespec now;
+         clock_gettime(CLOCK_MONOTONIC, &now);
+         uint64_t nowNs = static_cast<uint64_t>(now.tv_sec) * 1000000000ull + static_cast<uint64_t>(now.tv_nsec);
+         Log(LogLevel::Info, LogEvent::InputEdge, ioValues.Name(edge.handle), edge.value, 
+             (nowNs - edge.timestampNs) / 1000);
+      } // end while 
+
       result = digitalIo.ReadAll(ioValues);
       if(result != 0){
-         PrintLn((boost::format{ "read gpio error: %1%" } % digitalIo.GetErrorStr()).str());
+         Log(LogLevel::Error, LogEvent::GpioReadError, digitalIo.GetErrorStr());
          break;
       } // end if 
 
-      // set the events to the state machine
-      if(doorHomed == false){
-         sm.process_event(eStartUp{});
-      } 
-      else if(lightDataAvaliable == true || daytimeDataAvailable == true){
-         sm.process_event(eOnTime{dc});
+      // set the events to the state machine on the tick, a timer expiry or 
+      // when an input or the door command changed, a wakeup for a reader 
+      // result or console input alone doesn't need it
+      bool inputChanged = (ioValues != lastIoValues || dc != lastDc);
+      if(ticked == true || inputChanged == true || timersFired > 0) {
+         ProcessStateMachine(dc);
       } // end if 
-      // note: do nothing on else 
 
       digitalIo.SetOutputs(ioValues);
+      lastIoValues = ioValues;
+      lastDc = dc;
 
       // end main control loop
       ////////////////////////////////////////////////////////////////
@@ -351,10 +650,6 @@ int main(int argc, char* args[]){
       ////////////////////////////////////////////////////////////////
       // if(sm.is(sml::state<Failed>) == true) {cout << "failed state" << endl; break;}
 
-      // 
-      if(sm.is(sml::state<HomingComplete>) == true) 
-         doorHomed = true;
-
       if(sm.is(sml::state<ObstructionDetected>) == true) {
          PrintLn("main: ObstructionDetected");
       } // end if 
@@ -393,7 +688,7 @@ int main(int argc, char* args[]){
          pitr.ResetStatus();
       }
       else if(pitr.GetStatus() == ReaderStatus::Error) {
-         cout << pitr.GetError() << endl;
+         Log(LogLevel::Error, LogEvent::SensorReadError, pitr.GetError());
          pitr.ResetStatus();
       } // end if 
 
@@ -409,22 +704,23 @@ int main(int argc, char* args[]){
          Si7021Data data = si7021r.GetData();
          si7021r.ResetStatus();
 
-         string lightUnits = "lx";
+         // queue sensor data for the db writer thread, the units
+         // are in the readings units table
+         int sensorReadResult = dbw.PushSensorDataRow(clockService.Now(),
+                                                      data.temperature,
+                                                      data.humidity,
+                                                      light);
 
-         // write sensor data to db 
-         int sensorReadResult = udb.AddOneSensorDataRow(GetSqlite3DateTime(),  
-                                                        data.temperature,
-                                                        data.TemperatureUnits,
-                                                        data.humidity,
-                                                        data.humidityUnits,
-                                                        lightStr, lightUnits); 
+         coopStatus.Data().temperature = data.temperature;
+         coopStatus.Data().humidity = data.humidity;
+         coopStatus.Data().readingTime = clockService.Now();
          if(sensorReadResult == -1) {
-            cout << udb.GetErrorStr() << endl;
+            Log(LogLevel::Warn, LogEvent::DbRowDropped, "sensor data");
          } // end if 
 
       }
       else if(si7021r.GetStatus() == ReaderStatus::Error) {
-         cout << si7021r.GetError() << endl;
+         Log(LogLevel::Error, LogEvent::SensorReadError, si7021r.GetError());
          si7021r.ResetStatus();
       } // end if 
 
@@ -432,31 +728,101 @@ int main(int argc, char* args[]){
       ////////////////////////////////////////////////////////////////
 
       ////////////////////////////////////////////////////////////////
-      // read Tsl2591 light level every n seconds
+      // read Tsl2591 light level every n seconds, the sensor integrates
+      // continuously so the interval can be short
       if(tsl2591r.GetStatus() == ReaderStatus::NotStarted){
-         tsl2591r.ReadAfterSec(ac.sensorReadIntervalSec);
+         tsl2591r.ReadAfterSec(lightReadSec);
       }
       else if(tsl2591r.GetStatus() == ReaderStatus::Complete){
          Tsl2591Data data = tsl2591r.GetData();
          tsl2591r.ResetStatus();
 
-         lightQueue.Add(data.lightLevel);
+         // a saturated or low count read is only a limit, hold the filter
+         // on it unless there is nothing in it yet
+         if(data.quality == LuxQuality::Valid || lightQueue.IsReady() == false) {
+            lightQueue.Add(data.lightLevel);
+         } // end if 
          light = lightQueue.GetFilteredValue();
 
          lightStr = str(format("%.1f") %  light);
          lightDataAvaliable = true;
       }
       else if(tsl2591r.GetStatus() == ReaderStatus::Error) {
-         cout << tsl2591r.GetError() << endl;
+         Log(LogLevel::Error, LogEvent::SensorReadError, tsl2591r.GetError());
          tsl2591r.ResetStatus();
       } // end if 
 
       // end read Tsl2591 light level every n seconds
       ////////////////////////////////////////////////////////////////
-            
-      this_thread::sleep_for(chrono::milliseconds(ac.loopTimeMS));
+
+      // full rate while homing, moving or paused, slow tick at rest
+      bool atRest = doorHomed == true && (sm.is(sml::state<Open>) == true || 
+                                          sm.is(sml::state<Closed>) == true ||
+                                          sm.is(sml::state<Failed>) == true);
+      unsigned tickMS = (useEventLoop == true && atRest == true) ? ac.idleTickMS : ac.loopTimeMS;
+
+      ////////////////////////////////////////////////////////////////
+      // publish the live status, a copy into shared memory, no locks
+      {
+         CoopStatusData &sd = coopStatus.Data();
+         uint32_t passUs = static_cast<uint32_t>(clockService.SinceTickUs());
+         auto dbStats = dbw.GetStats();
+
+         sd.mode = static_cast<int32_t>(mode);
+         sd.doorHomed = doorHomed == true ? 1 : 0;
+         sd.light = light;
+         sd.lightAvailable = lightDataAvaliable == true ? 1 : 0;
+         sd.piTemperature = strtof(temperature.c_str(), nullptr);
+         sd.loopPasses++;
+         sd.loopLastUs = passUs;
+         if(passUs > sd.loopMaxUs) sd.loopMaxUs = passUs;
+         sd.loopTickMs = tickMS;
+         sd.dbQueueDepth = static_cast<uint32_t>(dbStats.queueDepth);
+         sd.dbDropped = dbStats.dropped;
+
+         coopStatus.Publish(clockService.Now());
+      }
+
+      http.CloseIdle();
+
+      // end publish the live status
+      ////////////////////////////////////////////////////////////////
+
+      ////////////////////////////////////////////////////////////////
+      // wait for the next event
+      if(useEventLoop == true) {
+
+         loop.SetTickMS(tickMS);
+
+         if(loop.Wait(ticked) < 0) {
+            cout << "event loop error: " << loop.GetErrorStr() << ", using the fixed loop time" << endl;
+            http.Close();
+            useEventLoop = false;
+            ticked = true;
+         } // end if 
+      }
+      else {
+         this_thread::sleep_for(chrono::milliseconds(ac.loopTimeMS));
+         ticked = true;
+      } // end if 
+
+      // end wait for the next event
+      ////////////////////////////////////////////////////////////////
    } // end while 
 
+   // a reader job still running calls loop.Wakeup() when it ends, wait
+   // for it before the loop closes its eventfd
+   pitr.CancelRead();
+   si7021r.CancelRead();
+   tsl2591r.CancelRead();
+
+   digitalIo.DisableEdgeEvents();
+   http.Close();
+   loop.Close();
+   coopStatus.Close();
+   nbTimer.Cancel();
+   srss.Stop();
+
    // all off  
    pwm.Enable(false);
    ioValues["direction"] = 1u;
@@ -465,6 +831,16 @@ int main(int argc, char* args[]){
    // restore cin to blocking mode 
    wc.Close();
 
+   // commit the rows still in the queue 
+   dbw.Stop();
+   auto dbStats = dbw.GetStats();
+   cout << "database writer: written " << dbStats.written << ", dropped " << dbStats.dropped 
+        << ", failed " << dbStats.failed << ", max commit " << dbStats.maxCommitUs << "us" << endl;
+
+   // write what is left in the log rings 
+   Log(LogLevel::Info, LogEvent::ProgramStop);
+   logger.Close();
+
    return 0;
 } // end main
 
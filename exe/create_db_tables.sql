@@ -1,16 +1,25 @@
 
-drop table door_state;
+-- the daemon (door/UpdateDatabase.cpp) makes the same tables and indexes
+-- on a new file and sets user_version, this script is for a manual rebuild
+
+-- readers (web page, chart) don't block the writer in WAL mode,
+-- journal_mode is stored in the file so this only needs to run once
+pragma journal_mode = wal;
+
+drop table if exists door_state;
 
 create table door_state (
   'id' INTEGER PRIMARY KEY AUTOINCREMENT,
   'timestamp' text not null,
   'state' int not null,
   'light' text not null,
-  'pi_temp' text not null
+  'pi_temp' text not null,
   'decision' text not null
 );
 
-insert into door_state (timestamp, state, light, pi_temp)
+create index door_state_timestamp_ix on door_state (timestamp);
+
+insert into door_state (timestamp, state, light, pi_temp, decision)
 values
  ('2020-07-17 13:10:00',1,'500.0','30.5','Sunrise_W_Offset'),
  ('2020-07-17 13:12:00',2,'500.0','30.5','Sunrise_W_Offset'),
@@ -26,36 +35,50 @@ select *
 from door_state
 order by id desc;
 
-drop table readings;
+drop table if exists readings;
 
+-- timestamp is utc unix epoch seconds, the units are in readings_units
 create table readings (
   'id' INTEGER PRIMARY KEY AUTOINCREMENT,
-  'timestamp' text not null,
-  'temperature' text not null,
-  'temperature_units' text not null,
-  'humidity' text not null,
-  'humidity_units' text not null,
-  'light' text not null,
-  'light_units' text not null
+  'timestamp' integer not null,
+  'temperature' real,
+  'humidity' real,
+  'light' real
 );
 
-insert into readings (timestamp, temperature, temperature_units, humidity, humidity_units, light, light_units)
+-- covers the chart query, timestamp range plus the plotted columns
+create index readings_timestamp_ix on readings (timestamp, temperature, humidity, light);
+
+insert into readings (timestamp, temperature, humidity, light)
 values
- ('2021-02-05 13:10:00','60.0','degF','30.0','%','500.0','lx'),
- ('2021-02-05 13:10:02','60.1','degF','30.1','%','500.0','lx'),
- ('2021-02-05 13:10:04','60.2','degF','30.2','%','500.0','lx'),
- ('2021-02-05 13:10:06','60.3','degF','30.3','%','500.0','lx'),
- ('2021-02-05 13:10:08','60.4','degF','30.4','%','500.0','lx'),
- ('2021-02-05 13:10:10','60.5','degF','30.5','%','500.0','lx'),
- ('2021-02-05 13:10:12','60.6','degF','30.6','%','500.0','lx'),
- ('2021-02-05 13:10:14','60.7','degF','30.7','%','500.0','lx');
+ (1612548600,60.0,30.0,500.0),
+ (1612548602,60.1,30.1,500.0),
+ (1612548604,60.2,30.2,500.0),
+ (1612548606,60.3,30.3,500.0),
+ (1612548608,60.4,30.4,500.0),
+ (1612548610,60.5,30.5,500.0),
+ (1612548612,60.6,30.6,500.0),
+ (1612548614,60.7,30.7,500.0);
 
-select *
+select id, datetime(timestamp, 'unixepoch', 'localtime'), temperature, humidity, light
 from readings
 order by id desc;
 
+drop table if exists readings_units;
+
+create table readings_units (
+  'name' text primary key,
+  'units' text not null
+);
+
+insert into readings_units (name, units)
+values
+ ('temperature','degF'),
+ ('humidity','%'),
+ ('light','lx');
+
 
-drop table sun_data;
+drop table if exists sun_data;
 
 create table sun_data (
   'id' INTEGER PRIMARY KEY AUTOINCREMENT,
@@ -64,6 +87,8 @@ create table sun_data (
   'sunset' text not null
 );
 
+create index sun_data_timestamp_ix on sun_data (timestamp);
+
 insert into sun_data (timestamp, sunrise, sunset)
 values
  ('2021-02-05 13:10:00','06:50:00','20:01:00'),
@@ -77,4 +102,34 @@ values
 
 select *
 from sun_data
-order by id desc;
\ No newline at end of file
+order by id desc;
+
+-- 5 minute and hourly rollups of readings, filled by the daemon,
+-- timestamp is the utc epoch start of the bucket
+drop table if exists readings_5min;
+drop table if exists readings_hourly;
+drop table if exists readings_rollup;
+
+create table readings_5min (
+  'timestamp' integer primary key,
+  'samples' integer not null,
+  'temperature_min' real, 'temperature_max' real, 'temperature_avg' real,
+  'humidity_min' real, 'humidity_max' real, 'humidity_avg' real,
+  'light_min' real, 'light_max' real, 'light_avg' real
+);
+
+create table readings_hourly (
+  'timestamp' integer primary key,
+  'samples' integer not null,
+  'temperature_min' real, 'temperature_max' real, 'temperature_avg' real,
+  'humidity_min' real, 'humidity_max' real, 'humidity_avg' real,
+  'light_min' real, 'light_max' real, 'light_avg' real
+);
+
+-- end of the rolled up time per rollup table
+create table readings_rollup (
+  'name' text primary key,
+  'watermark' integer not null
+);
+
+pragma user_version = 4;
@@ -0,0 +1,86 @@
+#include "../door/LogEvents.h"
+#include <iostream>
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+#include <string>
+#include <cstring>
+#include <ctime>
+
+
+using namespace std;
+
+// g++ -Wall -g -std=c++2a -ologdecode main.cpp
+// usage: logdecode <log file> [log file ...]
+// prints the binary log written by the door program (door/Logger.h) as text,
+// give the rotated files oldest first: logdecode coop.log.3 coop.log.2 coop.log.1 coop.log
+
+
+// local time with milliseconds "YYYY-MM-DD HH:MM:SS.mmm"
+string TimeToString(uint64_t timestampNs) {
+   time_t sec = static_cast<time_t>(timestampNs / 1000000000ull);
+   unsigned ms = static_cast<unsigned>((timestampNs / 1000000ull) % 1000);
+
+   tm local;
+   localtime_r(&sec, &local);
+
+   char buf[32];
+   strftime(buf, sizeof(buf), "%Y-%m-%d %H:%M:%S", &local);
+
+   ostringstream out;
+   out << buf << '.' << setw(3) << setfill('0') << ms;
+   return out.str();
+} // end TimeToString
+
+
+int DecodeFile(const string &path) {
+
+   ifstream in(path, ios::binary);
+   if(in.is_open() == false) {
+      cout << "can not open " << path << endl;
+      return -1;
+   } // end if
+
+   LogFileHeader header{};
+   in.read(reinterpret_cast<char *>(&header), sizeof(header));
+   if(in.good() == false || memcmp(header.magic, LOG_FILE_MAGIC, sizeof(header.magic)) != 0) {
+      cout << path << " is not a coop log file" << endl;
+      return -1;
+   } // end if
+
+   if(header.recordSize != LOG_RECORD_SIZE) {
+      cout << path << " has " << header.recordSize << " byte records, this tool reads " 
+           << LOG_RECORD_SIZE << endl;
+      return -1;
+   } // end if
+
+   // events added after this tool was built print as "event <id>"
+   if(header.eventCount > static_cast<uint32_t>(LogEvent::Count)) {
+      cout << path << " has newer events, rebuild logdecode" << endl;
+   } // end if
+
+   LogRecord record;
+   while(in.read(reinterpret_cast<char *>(&record), sizeof(record))) {
+      cout << TimeToString(record.timestampNs) << ' ' 
+           << setw(5) << setfill(' ') << left << LogLevelToString(record.level) << right << ' '
+           << FormatLogRecord(record) << '\n';
+   } // end while
+
+   return 0;
+} // end DecodeFile
+
+
+int main(int argc, char* argv[]){
+
+   if(argc < 2) {
+      cout << "usage: logdecode <log file> [log file ...]" << endl;
+      return 1;
+   } // end if
+
+   int ret = 0;
+   for(int i = 1; i < argc; ++i) {
+      if(DecodeFile(argv[i]) != 0) ret = 1;
+   } // end for
+
+   return ret;
+} // end main
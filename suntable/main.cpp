@@ -0,0 +1,119 @@
+#include "../door/SunTable.h"
+#include <iostream>
+#include <iomanip>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <cstring>
+#include <cstdlib>
+
+
+using namespace std;
+
+// g++ -Wall -g -std=c++2a -osuntable main.cpp ../door/SunTable.cpp ../door/SolarCalc.cpp ../door/DateTimeUtils.cpp -lboost_date_time
+// usage: suntable <table file> -g <latitude> <longitude>
+//        suntable <table file> [-j] [yyyy-mm-dd] [days]
+// -g generates the table for the location, the door program does the same
+// when the configured location changes. Otherwise prints the sun times of
+// days starting at the date (default today) in local time, -j prints them
+// as json in utc epoch seconds for the web page and the chart
+
+
+// local time "HH:MM", "--:--" for none
+string LocalHM(const ptime &utc) {
+   if(utc.is_special() == true) return "--:--";
+
+   ptime local;
+   ToLocalTime(utc, local);
+
+   ostringstream out;
+   out << setw(2) << setfill('0') << local.time_of_day().hours() << ':'
+       << setw(2) << setfill('0') << local.time_of_day().minutes();
+   return out.str();
+} // end LocalHM
+
+
+int main(int argc, char* argv[]){
+
+   if(argc < 2) {
+      cout << "usage: suntable <table file> -g <latitude> <longitude>" << endl;
+      cout << "       suntable <table file> [-j] [yyyy-mm-dd] [days]" << endl;
+      return 1;
+   } // end if
+
+   string path = argv[1];
+   SunTable table;
+
+   if(argc >= 5 && strcmp(argv[2], "-g") == 0) {
+      time_t now = time(nullptr);
+      tm utc;
+      gmtime_r(&now, &utc);
+
+      int year = SunTable::LeapYearFor(utc.tm_year + 1900);
+      if(table.Generate(path, atof(argv[3]), atof(argv[4]), year) != 0) {
+         cout << table.GetErrorStr() << endl;
+         return 1;
+      } // end if
+
+      cout << "wrote " << path << " for " << argv[3] << ", " << argv[4] << " (leap year " << year << ")" << endl;
+      return 0;
+   } // end if
+
+   int arg = 2;
+   bool json = (argc > arg && strcmp(argv[arg], "-j") == 0);
+   if(json == true) ++arg;
+
+   date first = day_clock::local_day();
+   unsigned count = 1;
+   try {
+      if(argc > arg) first = from_simple_string(argv[arg++]);
+   }
+   catch(std::exception &e) {
+      cout << "bad date: " << e.what() << endl;
+      return 1;
+   } // end try/catch
+   if(argc > arg) count = static_cast<unsigned>(atoi(argv[arg]));
+   if(count < 1) count = 1;
+   if(count > SUN_TABLE_DAYS) count = SUN_TABLE_DAYS;
+
+   // the file's own location, Open() would generate it for another one
+   {
+      ifstream in(path, ios::binary);
+      SunTableHeader header{};
+      in.read(reinterpret_cast<char *>(&header), sizeof(header));
+      if(in.good() == false || memcmp(header.magic, SUN_TABLE_MAGIC, sizeof(header.magic)) != 0) {
+         cout << path << " is not a sun table" << endl;
+         return 1;
+      } // end if
+
+      if(table.Open(path, header.latitude, header.longitude) != 0) {
+         cout << table.GetErrorStr() << endl;
+         return 1;
+      } // end if
+   }
+
+   if(json == true) {
+      cout << table.ToJson(first, count) << endl;
+      return 0;
+   } // end if
+
+   const SunTableHeader *header = table.GetHeader();
+   cout << "location " << header->latitude << ", " << header->longitude << ", local times" << endl;
+   cout << "date        dawn   rise   noon   set    dusk" << endl;
+
+   date day = first;
+   for(unsigned i = 0; i < count; ++i, day += days(1)) {
+      SunTimes times;
+      cout << to_iso_extended_string(day) << "  ";
+
+      if(table.GetTimes(day, times) == 0) {
+         cout << LocalHM(times.civilDawn) << "  " << LocalHM(times.rise) << "  " << LocalHM(times.transit) << "  "
+              << LocalHM(times.set) << "  " << LocalHM(times.civilDusk) << endl;
+      }
+      else {
+         cout << table.GetErrorStr() << endl;
+      } // end if
+   } // end for
+
+   return 0;
+} // end main
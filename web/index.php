@@ -12,22 +12,56 @@
 
          error_reporting(E_ERROR | E_WARNING | E_PARSE);
 
+         // send a command to the door program on its unix datagram socket,
+         // the message is "<seq> <cmd>" and the answer is "<seq> ok|dup|busy|error".
+         // a missing answer is resent with the same seq so the door program 
+         // can drop the copy. needs the php sockets extension
          function WriteMode(string $mode) { 
 
-            $coop_ipc_path = "/home/bjc/coop/exe/user_input.txt";
-            // echo $coop_ipc_path;
+            $coop_cmd_socket = "/home/bjc/coop/exe/coop.sock";
+            $seq = random_int(1, 2147483647);
+            $cmd = trim($mode);
 
-            $file = fopen($coop_ipc_path, "w");
-            if($file == false) {
-               echo "open failed ";
+            $sock = socket_create(AF_UNIX, SOCK_DGRAM, 0);
+            if($sock == false) {
+               echo "socket failed ";
                return;
-	         } // end if 
-	
-            fwrite($file, $mode);
-            fclose($file);
+            } // end if 
+
+            // bind a reply address so the door program can answer. an abstract
+            // name (leading nul) has no file, so a web server with a private
+            // /tmp still gets the answer and there is nothing to unlink
+            $reply_path = "\0coop_web_" . getmypid() . "_" . $seq;
+            if(socket_bind($sock, $reply_path) == false) {
+               echo "bind failed ";
+               socket_close($sock);
+               return;
+            } // end if 
+            socket_set_option($sock, SOL_SOCKET, SO_RCVTIMEO, array("sec" => 1, "usec" => 0));
+
+            $answer = "";
+            for($try = 0; $try < 3 && $answer == ""; $try++) {
+
+               $msg = $seq . " " . $cmd;
+               if(socket_sendto($sock, $msg, strlen($msg), 0, $coop_cmd_socket) === false) {
+                  break;
+               } // end if 
+
+               $buf = "";
+               $from = "";
+               if(socket_recvfrom($sock, $buf, 64, 0, $from) > 0) {
+                  list($ackSeq, $status) = array_pad(explode(" ", trim($buf), 2), 2, "");
+                  if((int)$ackSeq == $seq) $answer = $status;
+               } // end if 
 
-            // original is 0644 then 0646 adds write perm to 'other' 
-            chmod($coop_ipc_path, 0646);
+            } // end for 
+
+            socket_close($sock);
+
+            if($answer == "") 
+               echo "no answer from the door ";
+            else if($answer != "ok" && $answer != "dup") 
+               echo "command " . $answer . " ";
  
          } // end WriteMode
 
@@ -110,50 +144,42 @@
             } // end ctor 
          } // end class
 
-         $db = new GarageDB();
-         $db->exec('begin');
-         $result = $db->query('select * from door_state order by id desc limit 5');
-
-         $first = 1;
-         $rec_time = "None";
-         $state = "None";
-         $boardTemp = "None";
-         $lightLevel = "None";
-         $decision = "None";
-
-         while ($row = $result->fetchArray()) {
-
-            $rec_time = $row['timestamp'];
-            $stateStr = PrintState($row['state']);
-            $tempC = $row['pi_temp'];
-            $lightLevel = $row['light'];
-            $decision = $row['decision'];
-
-            $t=substr($rec_time,11,strlen($rec_time));
-            $y=substr($rec_time,0,4);
-            $md=substr($rec_time,5,5);
-            $d=$md . "-" . $y;
-            $td = $t . " " . $d;
-
-            // make a temp string like:  "20.6C,(69.2F)"
-            $temp_str = sprintf("%.1fC (%.1fF)",(float)$tempC,($tempC*(9/5))+32);
-
-            if($first == 1){
-
-               echo "<p class=\"current\"> The chicken door is <span class=\"current\">$stateStr</span>, $td</p>";
-               $first = 0;
-
-               echo "<table id=\"history\">
-                        <caption style=\"text-align:left\" >The last 10 Open and Closings: </caption>
-                        <tr>
-                           <th>Time and Date</th>
-                           <th>State</th>
-                           <th>Light Level</th>
-                           <th>Decision</th>
-                           <th>Pi Temperature</th>
-                        </tr> ";
-            }
-            else {
+         // the live status from the door program's shared memory, see 
+         // coopstatus/main.cpp, current and not the last committed row
+         $output = array();
+         exec("./coopstatus -j", $output);
+         $status = json_decode(implode("", $output), true);
+
+         if(!is_array($status) || isset($status['error'])) {
+            $why = is_array($status) ? $status['error'] : "no answer from coopstatus";
+            echo "<p class=\"current\"> The chicken door status is not available: $why</p>";
+            $status = null;
+         } // end if 
+
+         if($status) {
+            $td = date("H:i:s m-d-Y", $status['updated']);
+            $stateStr = PrintState($status['state']);
+            echo "<p class=\"current\"> The chicken door is <span class=\"current\">$stateStr</span>, $td</p>";
+
+            echo "<table id=\"history\">
+                     <caption style=\"text-align:left\" >The last 10 Open and Closings: </caption>
+                     <tr>
+                        <th>Time and Date</th>
+                        <th>State</th>
+                        <th>Light Level</th>
+                        <th>Decision</th>
+                        <th>Pi Temperature</th>
+                     </tr> ";
+
+            foreach($status['history'] as $row) {
+               $td = date("H:i:s m-d-Y", $row['time']);
+               $stateStr = PrintState($row['state']);
+               $tempC = $row['pi_temp'];
+               $lightLevel = $row['light'];
+               $decision = $row['decision'];
+
+               // make a temp string like:  "20.6C,(69.2F)"
+               $temp_str = sprintf("%.1fC (%.1fF)",(float)$tempC,($tempC*(9/5))+32);
 
                echo "<tr>
                         <td>$td</td>
@@ -163,23 +189,34 @@
                         <td>$temp_str</td>
                     </tr>";
             }
-         }
-         echo "</table>"; 
+            echo "</table>"; 
 
-         // get the ambient temperature, humidity, and light_level read from the i2c sensors
-         $result = $db->query('select * from readings order by id desc limit 1');
-         $row = $result->fetchArray();
-         $timestamp = $row['timestamp'];
-         $tempDegF = $row['temperature'];
-         $humidity = $row['humidity'];
-         $light = $row['light'];
+            // the ambient temperature, humidity, and light_level read from the i2c sensors
+            $timestamp = $status['reading_time'] ? date("Y-m-d H:i:s", $status['reading_time']) : "None";
+            $tempHumid = sprintf("Timestamp: %s, Temperature: %.1fdegF, humidity: %.1f%%, light: %.1f(lx)", 
+                                 $timestamp, $status['temperature'], $status['humidity'], $status['light']);
+            echo "<p class=\"current\"> $tempHumid";
 
-         $db->exec('end');
+            if($status['sunrise'] && $status['sunset']) {
+               $sun = sprintf("Sunrise: %s, sunset: %s", date("H:i", $status['sunrise']), date("H:i", $status['sunset']));
+               echo "<p class=\"current\"> $sun";
+            }
+         } // end if 
+
+         // last 24 hours high and low from the hourly rollup, not the raw rows,
+         // a rollup changes once an hour so it stays a database query
+         $db = new GarageDB();
+         $result = $db->query("select min(temperature_min) as tmin, max(temperature_max) as tmax, " .
+                              "min(humidity_min) as hmin, max(humidity_max) as hmax from readings_hourly " .
+                              "where timestamp >= (select max(timestamp) from readings_hourly) - 82800");
+         $day = $result ? $result->fetchArray() : false;
          $db->close();
 
-         // make a display string from the temp and humidity data 
-         $tempHumid = sprintf("Timestamp: %s, Temperature: %sdegF, humidity: %s%%, light: %s(lx)", $timestamp, $tempDegF, $humidity, $light);
-         echo "<p class=\"current\"> $tempHumid";
+         if($day && $day['tmin'] !== null) {
+            $dayRange = sprintf("Last 24 hours: Temperature %.1f to %.1fdegF, humidity %.1f to %.1f%%", 
+                                $day['tmin'], $day['tmax'], $day['hmin'], $day['hmax']);
+            echo "<p class=\"current\"> $dayRange";
+         }
          
          // make the chart file
          exec("./gnup");